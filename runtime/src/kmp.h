@@ -1074,6 +1074,7 @@ extern kmp_uint64 __kmp_now_nsec();
 #define KMP_DEFAULT_CHUNK 1
 
 #define KMP_DFLT_DISP_NUM_BUFF 7
+#define KMP_DFLT_DOACROSS_WINDOW 0
 #define KMP_MAX_ORDERED 8
 
 #define KMP_MAX_FIELDS 32
@@ -1161,6 +1162,7 @@ typedef struct kmp_cpuinfo {
   int stepping; // CPUID(1).EAX[3:0] ( Stepping )
   int sse2; // 0 if SSE2 instructions are not supported, 1 otherwise.
   int rtm; // 0 if RTM instructions are not supported, 1 otherwise.
+  int cmpxchg16b; // 0 if CMPXCHG16B is not supported, 1 otherwise.
   int cpu_stackoffset;
   int apic_id;
   int physical_id;
@@ -1215,6 +1217,24 @@ static inline void __kmp_store_mxcsr(kmp_uint32 *p) { *p = _mm_getcsr(); }
 static inline void __kmp_load_mxcsr(const kmp_uint32 *p) {}
 static inline void __kmp_store_mxcsr(kmp_uint32 *p) { *p = 0; }
 #endif
+#if KMP_ARCH_X86_64
+#define KMP_HAVE_CMPXCHG16B 1
+// 16-byte compare-and-store of the pair p[0..1], which must be 16-byte
+// aligned. On failure cv receives the current contents of p. Callers must
+// check __kmp_cpuinfo.cmpxchg16b first.
+static inline bool __kmp_compare_and_store128(volatile kmp_int64 *p,
+                                              kmp_int64 *cv,
+                                              const kmp_int64 *sv) {
+  bool ok;
+  __asm__ __volatile__("lock; cmpxchg16b %1\n\t"
+                       "sete %0"
+                       : "=q"(ok), "+m"(*(volatile __int128 *)p),
+                         "+a"(cv[0]), "+d"(cv[1])
+                       : "b"(sv[0]), "c"(sv[1])
+                       : "memory", "cc");
+  return ok;
+}
+#endif
 #else
 // Windows still has these as external functions in assembly file
 extern void __kmp_x86_cpuid(int mode, int mode2, struct kmp_cpuid *p);
@@ -1253,6 +1273,10 @@ static inline void __kmp_x86_pause(void) { _mm_pause(); }
 #define KMP_CPU_PAUSE() /* nothing to do */
 #endif
 
+#ifndef KMP_HAVE_CMPXCHG16B
+#define KMP_HAVE_CMPXCHG16B 0
+#endif
+
 #define KMP_INIT_YIELD(count)                                                  \
   { (count) = __kmp_yield_init; }
 
@@ -1528,11 +1552,13 @@ typedef struct kmp_sched_flags {
   unsigned ordered : 1;
   unsigned nomerge : 1;
   unsigned contains_last : 1;
+  unsigned steal_packed : 1; // static_steal: (count, ub) packed in 8 bytes
+  unsigned steal_dcas : 1; // static_steal: (count, ub) updated by 16-byte CAS
 #if KMP_USE_HIER_SCHED
   unsigned use_hier : 1;
-  unsigned unused : 28;
+  unsigned unused : 26;
 #else
-  unsigned unused : 29;
+  unsigned unused : 27;
 #endif
 } kmp_sched_flags_t;
 
@@ -1698,6 +1724,9 @@ typedef struct dispatch_shared_info {
   volatile kmp_int32 doacross_buf_idx; // teamwise index
   volatile kmp_uint32 *doacross_flags; // shared array of iteration flags (0/1)
   kmp_int32 doacross_num_done; // count finished threads
+  kmp_int32 doacross_sleepers; // threads sleeping in doacross waits
+  void *volatile auto_loop; // adaptive schedule(auto) instance
+  volatile kmp_uint64 ring_claim; // elastic ring: loops decided for the slot
 #if KMP_USE_HIER_SCHED
   void *hier;
 #endif
@@ -1824,6 +1853,20 @@ static inline void copy_icvs(kmp_internal_control_t *dst,
   *dst = *src;
 }
 
+static inline bool same_icvs(const kmp_internal_control_t *a,
+                             const kmp_internal_control_t *b) {
+  return a->serial_nesting_level == b->serial_nesting_level &&
+         a->dynamic == b->dynamic && a->bt_set == b->bt_set &&
+         a->blocktime == b->blocktime &&
+#if KMP_USE_MONITOR
+         a->bt_intervals == b->bt_intervals &&
+#endif
+         a->nproc == b->nproc && a->thread_limit == b->thread_limit &&
+         a->max_active_levels == b->max_active_levels &&
+         a->sched.sched == b->sched.sched && a->proc_bind == b->proc_bind &&
+         a->default_device == b->default_device && a->next == b->next;
+}
+
 /* Thread barrier needs volatile barrier fields */
 typedef struct KMP_ALIGN_CACHE kmp_bstate {
   // th_fixed_icvs is aligned by virtue of kmp_bstate being aligned (and all
@@ -2049,6 +2092,10 @@ typedef struct kmp_local {
 #define get__proc_bind(xthread)                                                \
   ((xthread)->th.th_current_task->td_icvs.proc_bind)
 
+// Must be applied to an implicit task whose ICVs are changed in place, so the
+// next fork barrier does not consider its copy of the team's ICVs current.
+#define KMP_ICVS_CHANGED(xtask) ((xtask)->td_icv_version = 0)
+
 // OpenMP tasking data structures
 
 typedef enum kmp_tasking_mode {
@@ -2276,6 +2323,8 @@ struct kmp_taskdata { /* aligned during dynamic allocation       */
   kmp_int32 td_taskwait_thread; /* gtid + 1 of thread encountered taskwait */
   KMP_ALIGN_CACHE kmp_internal_control_t
       td_icvs; /* Internal control variables for the task */
+  kmp_uint32 td_icv_version; /* t_icv_version td_icvs was pulled from, 0 once
+                               the ICVs are changed in place */
   KMP_ALIGN_CACHE std::atomic<kmp_int32>
       td_allocated_child_tasks; /* Child tasks (+ current task) not yet
                                    deallocated */
@@ -2492,6 +2541,13 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
 
   volatile kmp_uint32 th_spin_here; /* thread-local location for spinning */
   /* while awaiting queuing lock acquire */
+  kmp_int32 th_lock_node; /* node+1 of the thread for cohort locks, 0 if not
+                             known yet */
+  struct kmp_atomic_cnode *th_atomic_cnode; /* spare node for combining
+                                               atomics */
+#if KMP_USE_DYNAMIC_LOCK
+  kmp_indirect_lock_pool_t th_i_lock_pool; /* destroyed indirect locks */
+#endif
 
   volatile void *th_sleep_loc; // this points at a kmp_flag<T>
 
@@ -2632,6 +2688,8 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
   KMP_ALIGN_CACHE void **t_argv;
   int t_argc;
   int t_nproc; // number of threads in team
+  // magic number for dividing by t_nproc (see kmp_sched.cpp), set lazily
+  volatile kmp_uint64 t_nproc_div;
   microtask_t t_pkfn;
   launch_t t_invoke; // procedure to launch the microtask
 
@@ -2654,10 +2712,18 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
       *t_implicit_task_taskdata; // Taskdata for the thread's implicit task
   int t_level; // nested parallel level
 
+  // Master's ICVs for the region, refreshed in the fork barrier.  Workers copy
+  // them into their implicit task only when t_icv_version has moved on.
+  KMP_ALIGN_CACHE kmp_internal_control_t t_icvs;
+  kmp_uint32 t_icv_version;
+
   KMP_ALIGN_CACHE int t_max_argc;
   int t_max_nproc; // max threads this team can handle (dynamicly expandable)
   int t_serialized; // levels deep of serialized teams
   dispatch_shared_info_t *t_disp_buffer; // buffers for dispatch system
+  void *t_disp_overflow; // loops moved off the busy dispatch ring
+  void *t_disp_overflow_free; // overflow buffers kept for reuse
+  void *volatile t_ordered_waiters; // threads waiting in ordered loops
   int t_id; // team's id, assigned by debugger.
   int t_active_level; // nested active parallel level
   kmp_r_sched_t t_sched; // run-time schedule for the team
@@ -2738,6 +2804,12 @@ typedef struct kmp_base_root {
   kmp_lock_t r_begin_lock;
   volatile int r_begin;
   int r_blocktime; /* blocktime for this root and descendants */
+#if KMP_NESTED_HOT_TEAMS
+  // Inner teams parked with their threads when freed, linked by t_next_pool
+  // and reused by a fork with the same level, size and binding
+  kmp_team_t *r_nested_teams;
+  int r_nested_teams_count;
+#endif
 } kmp_base_root_t;
 
 typedef union KMP_ALIGN_CACHE kmp_root {
@@ -2760,6 +2832,7 @@ extern int __kmp_forkjoin_frames_mode;
 #endif
 extern PACKED_REDUCTION_METHOD_T __kmp_force_reduction_method;
 extern int __kmp_determ_red;
+extern int __kmp_fused_reduction_barrier; /* KMP_FUSED_REDUCTION_BARRIER */
 
 #ifdef KMP_DEBUG
 extern int kmp_a_debug;
@@ -2868,6 +2941,8 @@ extern enum sched_type __kmp_sched; /* default runtime scheduling */
 extern enum sched_type __kmp_static; /* default static scheduling method */
 extern enum sched_type __kmp_guided; /* default guided scheduling method */
 extern enum sched_type __kmp_auto; /* default auto scheduling method */
+extern int __kmp_adaptive_auto; /* KMP_ADAPTIVE_AUTO */
+extern int __kmp_dispatch_chunk_batch; /* KMP_DISP_CHUNK_BATCH */
 extern int __kmp_chunk; /* default runtime chunk size */
 
 extern size_t __kmp_stksize; /* stack size per thread         */
@@ -2968,10 +3043,17 @@ extern int __kmp_dflt_max_active_levels;
 extern bool __kmp_dflt_max_active_levels_set;
 extern int __kmp_dispatch_num_buffers; /* max possible dynamic loops in
                                           concurrent execution per team */
+extern int __kmp_dispatch_elastic; /* KMP_DISP_ELASTIC */
+extern int __kmp_steal_pair; /* KMP_STEAL_PAIR */
+extern int __kmp_doacross_window; /* KMP_DOACROSS_WINDOW */
+extern int __kmp_dist_elem_size; /* KMP_DIST_ELEMENT_SIZE */
 #if KMP_NESTED_HOT_TEAMS
 extern int __kmp_hot_teams_mode;
 extern int __kmp_hot_teams_max_level;
+extern int __kmp_nested_teams_cache; /* KMP_NESTED_TEAMS_CACHE */
 #endif
+extern int __kmp_fast_fork; /* KMP_FAST_FORK */
+extern int __kmp_prespawn_threads; /* KMP_PRESPAWN_THREADS */
 
 #if KMP_OS_LINUX
 extern enum clock_function_type __kmp_clock_function;
@@ -3300,6 +3382,9 @@ extern void __kmp_release_64(kmp_flag_64 *flag);
 extern void __kmp_infinite_loop(void);
 
 extern void __kmp_cleanup(void);
+extern void __kmp_cleanup_loop_weights(void);
+extern void __kmp_dispatch_free_overflow(kmp_team_t *team);
+extern void __kmp_dispatch_free_ordered(kmp_team_t *team);
 
 #if KMP_HANDLE_SIGNALS
 extern int __kmp_handle_signals;
@@ -3376,6 +3461,10 @@ extern void __kmp_create_monitor(kmp_info_t *th);
 extern void *__kmp_launch_thread(kmp_info_t *thr);
 
 extern void __kmp_create_worker(int gtid, kmp_info_t *th, size_t stack_size);
+#if KMP_OS_UNIX
+extern int __kmp_create_prespawn_thread(void *(*func)(void *));
+extern void __kmp_join_prespawn_thread(void);
+#endif
 
 #if KMP_OS_WINDOWS
 extern int __kmp_still_running(kmp_info_t *th);
@@ -3450,6 +3539,9 @@ extern int __kmp_barrier(enum barrier_type bt, int gtid, int is_split,
                          size_t reduce_size, void *reduce_data,
                          void (*reduce)(void *, void *));
 extern void __kmp_end_split_barrier(enum barrier_type bt, int gtid);
+extern int __kmp_barrier_gather_reduce(enum barrier_type bt, int gtid,
+                                       size_t reduce_size, void *reduce_data,
+                                       void (*reduce)(void *, void *));
 extern int __kmp_barrier_gomp_cancel(int gtid);
 
 /*!
@@ -3871,6 +3963,13 @@ KMP_EXPORT void KMPC_CONVENTION kmpc_set_stacksize_s(size_t);
 KMP_EXPORT void KMPC_CONVENTION kmpc_set_library(int);
 KMP_EXPORT void KMPC_CONVENTION kmpc_set_defaults(char const *);
 KMP_EXPORT void KMPC_CONVENTION kmpc_set_disp_num_buffers(int);
+KMP_EXPORT void KMPC_CONVENTION kmpc_set_loop_weights(char const *,
+                                                     const kmp_uint64 *,
+                                                     size_t);
+KMP_EXPORT void KMPC_CONVENTION kmpc_set_dist_element_size(size_t);
+KMP_EXPORT void KMPC_CONVENTION kmpc_print_lock_profile(int);
+// The kmpc_*_rw_lock and kmpc_*_{rd,wr}_lock functions take an omp_lock_t and
+// are declared in omp.h.
 
 enum kmp_target_offload_kind {
   tgt_disabled = 0,
@@ -4901,6 +4901,7 @@ int __kmp_aux_set_affinity(void **mask) {
 
   // Turn off 4.0 affinity for the current tread at this parallel level.
   th->th.th_current_task->td_icvs.proc_bind = proc_bind_false;
+  KMP_ICVS_CHANGED(th->th.th_current_task);
 
   return retval;
 }
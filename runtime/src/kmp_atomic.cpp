@@ -562,40 +562,17 @@ on a `complex<double>` or `complex(kind=8)`, *not* `complex<float>`.
  * Global vars
  */
 
-#ifndef KMP_GOMP_COMPAT
+// GOMP compatibility mode (2), where every atomic takes __kmp_atomic_lock like
+// GOMP_atomic_start() does, is only used when requested with KMP_ATOMIC_MODE.
 int __kmp_atomic_mode = 1; // Intel perf
-#else
-int __kmp_atomic_mode = 2; // GOMP compatibility
-#endif /* KMP_GOMP_COMPAT */
+int __kmp_atomic_combine = 0; // no combining
 
 KMP_ALIGN(128)
 
 // Control access to all user coded atomics in Gnu compat mode
 kmp_atomic_lock_t __kmp_atomic_lock;
-// Control access to all user coded atomics for 1-byte fixed data types
-kmp_atomic_lock_t __kmp_atomic_lock_1i;
-// Control access to all user coded atomics for 2-byte fixed data types
-kmp_atomic_lock_t __kmp_atomic_lock_2i;
-// Control access to all user coded atomics for 4-byte fixed data types
-kmp_atomic_lock_t __kmp_atomic_lock_4i;
-// Control access to all user coded atomics for kmp_real32 data type
-kmp_atomic_lock_t __kmp_atomic_lock_4r;
-// Control access to all user coded atomics for 8-byte fixed data types
-kmp_atomic_lock_t __kmp_atomic_lock_8i;
-// Control access to all user coded atomics for kmp_real64 data type
-kmp_atomic_lock_t __kmp_atomic_lock_8r;
-// Control access to all user coded atomics for complex byte data type
-kmp_atomic_lock_t __kmp_atomic_lock_8c;
-// Control access to all user coded atomics for long double data type
-kmp_atomic_lock_t __kmp_atomic_lock_10r;
-// Control access to all user coded atomics for _Quad data type
-kmp_atomic_lock_t __kmp_atomic_lock_16r;
-// Control access to all user coded atomics for double complex data type
-kmp_atomic_lock_t __kmp_atomic_lock_16c;
-// Control access to all user coded atomics for long double complex type
-kmp_atomic_lock_t __kmp_atomic_lock_20c;
-// Control access to all user coded atomics for _Quad complex data type
-kmp_atomic_lock_t __kmp_atomic_lock_32c;
+// Control access to the other user coded atomics, by target address
+kmp_atomic_lock_t __kmp_atomic_locks[KMP_ATOMIC_LOCKS];
 
 /* 2007-03-02:
    Without "volatile" specifier in OP_CMPXCHG and MIN_MAX_CMPXCHG we have a bug
@@ -699,19 +676,74 @@ static inline void operator/=(kmp_cmplx128_a16_t &lhs,
 
 // ------------------------------------------------------------------------
 // Lock variables used for critical sections for various size operands
-#define ATOMIC_LOCK0 __kmp_atomic_lock // all types, for Gnu compat
-#define ATOMIC_LOCK1i __kmp_atomic_lock_1i // char
-#define ATOMIC_LOCK2i __kmp_atomic_lock_2i // short
-#define ATOMIC_LOCK4i __kmp_atomic_lock_4i // long int
-#define ATOMIC_LOCK4r __kmp_atomic_lock_4r // float
-#define ATOMIC_LOCK8i __kmp_atomic_lock_8i // long long int
-#define ATOMIC_LOCK8r __kmp_atomic_lock_8r // double
-#define ATOMIC_LOCK8c __kmp_atomic_lock_8c // float complex
-#define ATOMIC_LOCK10r __kmp_atomic_lock_10r // long double
-#define ATOMIC_LOCK16r __kmp_atomic_lock_16r // _Quad
-#define ATOMIC_LOCK16c __kmp_atomic_lock_16c // double complex
-#define ATOMIC_LOCK20c __kmp_atomic_lock_20c // long double complex
-#define ATOMIC_LOCK32c __kmp_atomic_lock_32c // _Quad complex
+#define ATOMIC_LOCK0(addr) (&__kmp_atomic_lock) // all types, for Gnu compat
+#define ATOMIC_LOCK1i(addr) __kmp_atomic_lock_of(addr) // char
+#define ATOMIC_LOCK2i(addr) __kmp_atomic_lock_of(addr) // short
+#define ATOMIC_LOCK4i(addr) __kmp_atomic_lock_of(addr) // long int
+#define ATOMIC_LOCK4r(addr) __kmp_atomic_lock_of(addr) // float
+#define ATOMIC_LOCK8i(addr) __kmp_atomic_lock_of(addr) // long long int
+#define ATOMIC_LOCK8r(addr) __kmp_atomic_lock_of(addr) // double
+#define ATOMIC_LOCK8c(addr) __kmp_atomic_lock_of(addr) // float complex
+#define ATOMIC_LOCK10r(addr) __kmp_atomic_lock_of(addr) // long double
+#define ATOMIC_LOCK16r(addr) __kmp_atomic_lock_of(addr) // _Quad
+#define ATOMIC_LOCK16c(addr) __kmp_atomic_lock_of(addr) // double complex
+#define ATOMIC_LOCK20c(addr) __kmp_atomic_lock_of(addr) // long double complex
+#define ATOMIC_LOCK32c(addr) __kmp_atomic_lock_of(addr) // _Quad complex
+
+#if KMP_HAVE_CMPXCHG16B
+// ------------------------------------------------------------------------
+// The 16-byte types (_Quad, double complex, and long double where it takes 16
+// bytes) are updated lock free with cmpxchg16b if the CPU has it and the
+// target is 16-byte aligned, also by the generic __kmpc_atomic_16. Which path
+// an address takes never changes, so the lock is a safe fallback.
+#define ATOMIC_DCAS0 0
+#define ATOMIC_DCAS1i 0
+#define ATOMIC_DCAS2i 0
+#define ATOMIC_DCAS4i 0
+#define ATOMIC_DCAS4r 0
+#define ATOMIC_DCAS8i 0
+#define ATOMIC_DCAS8r 0
+#define ATOMIC_DCAS8c 0
+#define ATOMIC_DCAS10r (sizeof(long double) == 16)
+#define ATOMIC_DCAS16r 1
+#define ATOMIC_DCAS16c 1
+#define ATOMIC_DCAS20c 0
+#define ATOMIC_DCAS32c 0
+
+#define KMP_ATOMIC_DCAS(LCK_ID, ADDR)                                          \
+  (ATOMIC_DCAS##LCK_ID && __kmp_cpuinfo.cmpxchg16b &&                          \
+   ((kmp_uintptr_t)(ADDR)&0xf) == 0)
+
+// Operation on 16-byte *ADDR using cmpxchg16b: STMT computes new_value from
+// old_value and is repeated until the compare and store succeeds. The first
+// load may be torn, the compare and store catches it.
+#define OP_CMPXCHG16(ADDR, STMT)                                               \
+  {                                                                            \
+    kmp_int64 cv[2], sv[2];                                                    \
+    cv[0] = ((volatile kmp_int64 *)(ADDR))[0];                                 \
+    cv[1] = ((volatile kmp_int64 *)(ADDR))[1];                                 \
+    KMP_MEMCPY(&old_value, cv, sizeof(cv));                                    \
+    STMT;                                                                      \
+    KMP_MEMCPY(sv, &new_value, sizeof(sv));                                    \
+    while (!__kmp_compare_and_store128((volatile kmp_int64 *)(ADDR), cv,       \
+                                       sv)) {                                  \
+      KMP_CPU_PAUSE();                                                         \
+      KMP_MEMCPY(&old_value, cv, sizeof(cv));                                  \
+      STMT;                                                                    \
+      KMP_MEMCPY(sv, &new_value, sizeof(sv));                                  \
+    }                                                                          \
+  }
+
+// Lock free path of the critical section routines, RET leaves the routine
+#define OP_DCAS(TYPE, ADDR, LCK_ID, STMT, RET)                                 \
+  if (KMP_ATOMIC_DCAS(LCK_ID, ADDR)) {                                         \
+    TYPE old_value, new_value;                                                 \
+    OP_CMPXCHG16(ADDR, STMT)                                                   \
+    RET;                                                                       \
+  }
+#else
+#define OP_DCAS(TYPE, ADDR, LCK_ID, STMT, RET)
+#endif // KMP_HAVE_CMPXCHG16B
 
 // ------------------------------------------------------------------------
 // Operation on *lhs, rhs bound by critical section
@@ -720,11 +752,11 @@ static inline void operator/=(kmp_cmplx128_a16_t &lhs,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL(OP, LCK_ID)                                                \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   (*lhs) OP(rhs);                                                              \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);
 
 // ------------------------------------------------------------------------
 // For GNU compatibility, we may need to use a critical section,
@@ -815,6 +847,153 @@ static inline void operator/=(kmp_cmplx128_a16_t &lhs,
 // end of the first part of the workaround for C78287
 #endif // USE_CMPXCHG_FIX
 
+// ------------------------------------------------------------------------
+// Combining of contended double additions (CC-Synch). After
+// __kmp_atomic_combine failed compare and stores a thread queues its operand
+// on the combining slot of the address instead, and waits on its own node.
+// The thread at the head of the queue applies the queued operands, with one
+// compare and store per run of operands for the same address, and then hands
+// the role on to the next waiting thread.
+#define KMP_ATOMIC_COMBINE_MAX 64 // operands applied by one combiner
+
+typedef struct kmp_atomic_cnode {
+  std::atomic<struct kmp_atomic_cnode *> next; // set once the request is ready
+  volatile kmp_uint32 wait; // 0 - request done or the node's owner combines
+  volatile kmp_uint32 completed; // 1 - request done
+  kmp_real64 *addr;
+  kmp_real64 delta;
+} kmp_atomic_cnode_t;
+
+typedef struct KMP_ALIGN_CACHE kmp_atomic_cslot {
+  std::atomic<kmp_atomic_cnode_t *> tail;
+} kmp_atomic_cslot_t;
+
+// Slots are picked like the atomic locks. Every node is either the spare node
+// of a thread or queued on a slot, so the two lists own all of them.
+static kmp_atomic_cslot_t __kmp_atomic_cslots[KMP_ATOMIC_LOCKS];
+
+static kmp_atomic_cnode_t *__kmp_atomic_cnode_alloc(kmp_uint32 wait) {
+  kmp_atomic_cnode_t *node =
+      (kmp_atomic_cnode_t *)__kmp_allocate(sizeof(kmp_atomic_cnode_t));
+  node->next = NULL;
+  node->wait = wait;
+  node->completed = 0;
+  return node;
+}
+
+static void __kmp_atomic_add_8r(kmp_real64 *lhs, kmp_real64 rhs) {
+  OP_CMPXCHG(kmp_real64, 64, +)
+}
+
+// Finish the requests from node up to but not including last
+static void __kmp_atomic_cnode_release(kmp_atomic_cnode_t *node,
+                                       kmp_atomic_cnode_t *last) {
+  while (node != last) {
+    // the owner may reuse the node as soon as it sees it done
+    kmp_atomic_cnode_t *next = node->next.load(std::memory_order_relaxed);
+    node->completed = 1;
+    KMP_MB();
+    node->wait = 0;
+    node = next;
+  }
+}
+
+static void __kmp_atomic_combine_8r(int gtid, kmp_real64 *lhs,
+                                    kmp_real64 delta) {
+  kmp_info_t *th = __kmp_threads[gtid];
+  kmp_atomic_cslot_t *slot = &__kmp_atomic_cslots[__kmp_atomic_stripe(lhs)];
+  kmp_atomic_cnode_t *node = th->th.th_atomic_cnode;
+  kmp_atomic_cnode_t *own, *run, *req, *next;
+  kmp_real64 sum;
+  int count;
+
+  if (node == NULL)
+    node = __kmp_atomic_cnode_alloc(1);
+  if (slot->tail.load(std::memory_order_acquire) == NULL) {
+    kmp_atomic_cnode_t *dummy = __kmp_atomic_cnode_alloc(0);
+    kmp_atomic_cnode_t *expected = NULL;
+    if (!slot->tail.compare_exchange_strong(expected, dummy))
+      __kmp_free(dummy);
+  }
+
+  // Our spare node becomes the new tail, the request goes into the old one
+  node->next.store(NULL, std::memory_order_relaxed);
+  node->wait = 1;
+  node->completed = 0;
+  own = slot->tail.exchange(node);
+  own->addr = lhs;
+  own->delta = delta;
+  own->next.store(node, std::memory_order_release);
+
+  KMP_WAIT(&own->wait, 0, __kmp_eq_4, NULL);
+  KMP_MB();
+  if (!own->completed) {
+    // Combine, starting with our own request
+    run = req = own;
+    sum = 0;
+    for (count = 0; count < KMP_ATOMIC_COMBINE_MAX; ++count) {
+      next = req->next.load(std::memory_order_acquire);
+      if (next == NULL)
+        break;
+      if (req->addr != run->addr) {
+        __kmp_atomic_add_8r(run->addr, sum);
+        __kmp_atomic_cnode_release(run, req);
+        run = req;
+        sum = 0;
+      }
+      sum += req->delta;
+      req = next;
+    }
+    __kmp_atomic_add_8r(run->addr, sum);
+    __kmp_atomic_cnode_release(run, req);
+    // The owner of the first request left over combines next
+    KMP_MB();
+    req->wait = 0;
+  }
+  // The old tail is ours now, nobody else refers to it any more
+  th->th.th_atomic_cnode = own;
+}
+
+void __kmp_cleanup_atomic_combine(void) {
+  int i;
+  for (i = 0; i < KMP_ATOMIC_LOCKS; ++i) {
+    kmp_atomic_cnode_t *tail = __kmp_atomic_cslots[i].tail.load();
+    if (tail != NULL) {
+      __kmp_free(tail);
+      __kmp_atomic_cslots[i].tail.store(NULL);
+    }
+  }
+}
+
+// ------------------------------------------------------------------------
+// Operation on *lhs, rhs using "compare_and_store" routine, which turns to
+// combining after __kmp_atomic_combine failures (only for additions)
+//     TYPE    - operands' type
+//     BITS    - size in bits, used to distinguish low level calls
+//     OP      - operator, + or -
+//     LCK_ID  - type identifier of the combining routine
+#define OP_CMPXCHG_COMBINE(TYPE, BITS, OP, LCK_ID)                             \
+  {                                                                            \
+    TYPE old_value, new_value;                                                 \
+    int failures = 0;                                                          \
+    old_value = *(TYPE volatile *)lhs;                                         \
+    new_value = old_value OP rhs;                                              \
+    while (!KMP_COMPARE_AND_STORE_ACQ##BITS(                                   \
+        (kmp_int##BITS *)lhs, *VOLATILE_CAST(kmp_int##BITS *) & old_value,     \
+        *VOLATILE_CAST(kmp_int##BITS *) & new_value)) {                        \
+      if (__kmp_atomic_combine && ++failures >= __kmp_atomic_combine) {        \
+        KMP_CHECK_GTID;                                                        \
+        /* OP used as a sign for subtraction: (lhs-rhs) --> (lhs+-rhs) */      \
+        __kmp_atomic_combine_##LCK_ID(gtid, lhs, OP rhs);                      \
+        return;                                                                \
+      }                                                                        \
+      KMP_DO_PAUSE;                                                            \
+                                                                               \
+      old_value = *(TYPE volatile *)lhs;                                       \
+      new_value = old_value OP rhs;                                            \
+    }                                                                          \
+  }
+
 #if KMP_ARCH_X86 || KMP_ARCH_X86_64
 
 // ------------------------------------------------------------------------
@@ -833,6 +1012,13 @@ static inline void operator/=(kmp_cmplx128_a16_t &lhs,
   OP_GOMP_CRITICAL(OP## =, GOMP_FLAG)                                          \
   OP_CMPXCHG(TYPE, BITS, OP)                                                   \
   }
+// -------------------------------------------------------------------------
+#define ATOMIC_CMPXCHG_COMBINE(TYPE_ID, OP_ID, TYPE, BITS, OP, LCK_ID, MASK,   \
+                               GOMP_FLAG)                                      \
+  ATOMIC_BEGIN(TYPE_ID, OP_ID, TYPE, void)                                     \
+  OP_GOMP_CRITICAL(OP## =, GOMP_FLAG)                                          \
+  OP_CMPXCHG_COMBINE(TYPE, BITS, OP, LCK_ID)                                   \
+  }
 #if USE_CMPXCHG_FIX
 // -------------------------------------------------------------------------
 // workaround for C78287 (complex(kind=4) data type)
@@ -872,6 +1058,18 @@ static inline void operator/=(kmp_cmplx128_a16_t &lhs,
     OP_CRITICAL(OP## =, LCK_ID) /* unaligned address - use critical */         \
   }                                                                            \
   }
+// -------------------------------------------------------------------------
+#define ATOMIC_CMPXCHG_COMBINE(TYPE_ID, OP_ID, TYPE, BITS, OP, LCK_ID, MASK,   \
+                               GOMP_FLAG)                                      \
+  ATOMIC_BEGIN(TYPE_ID, OP_ID, TYPE, void)                                     \
+  OP_GOMP_CRITICAL(OP## =, GOMP_FLAG)                                          \
+  if (!((kmp_uintptr_t)lhs & 0x##MASK)) {                                      \
+    OP_CMPXCHG_COMBINE(TYPE, BITS, OP, LCK_ID) /* aligned address */           \
+  } else {                                                                     \
+    KMP_CHECK_GTID;                                                            \
+    OP_CRITICAL(OP## =, LCK_ID) /* unaligned address - use critical */         \
+  }                                                                            \
+  }
 #if USE_CMPXCHG_FIX
 // -------------------------------------------------------------------------
 // workaround for C78287 (complex(kind=4) data type)
@@ -907,10 +1105,10 @@ ATOMIC_FIXED_ADD(fixed8, add, kmp_int64, 64, +, 8i, 7,
 ATOMIC_FIXED_ADD(fixed8, sub, kmp_int64, 64, -, 8i, 7,
                  KMP_ARCH_X86) // __kmpc_atomic_fixed8_sub
 
-ATOMIC_CMPXCHG(float8, add, kmp_real64, 64, +, 8r, 7,
-               KMP_ARCH_X86) // __kmpc_atomic_float8_add
-ATOMIC_CMPXCHG(float8, sub, kmp_real64, 64, -, 8r, 7,
-               KMP_ARCH_X86) // __kmpc_atomic_float8_sub
+ATOMIC_CMPXCHG_COMBINE(float8, add, kmp_real64, 64, +, 8r, 7,
+                       KMP_ARCH_X86) // __kmpc_atomic_float8_add
+ATOMIC_CMPXCHG_COMBINE(float8, sub, kmp_real64, 64, -, 8r, 7,
+                       KMP_ARCH_X86) // __kmpc_atomic_float8_sub
 
 // ------------------------------------------------------------------------
 // Entries definition for integer operands
@@ -1081,12 +1279,12 @@ ATOMIC_CMPX_L(fixed8, orl, kmp_int64, 64, ||, 8i, 7,
 // MIN and MAX need separate macros
 // OP - operator to check if we need any actions?
 #define MIN_MAX_CRITSECT(OP, LCK_ID)                                           \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (*lhs OP rhs) { /* still need actions? */                                 \
     *lhs = rhs;                                                                \
   }                                                                            \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);
 
 // -------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -1124,6 +1322,8 @@ ATOMIC_CMPX_L(fixed8, orl, kmp_int64, 64, ||, 8i, 7,
   ATOMIC_BEGIN(TYPE_ID, OP_ID, TYPE, void)                                     \
   if (*lhs OP rhs) { /* need actions? */                                       \
     GOMP_MIN_MAX_CRITSECT(OP, GOMP_FLAG)                                       \
+    OP_DCAS(TYPE, lhs, LCK_ID,                                                 \
+            new_value = old_value OP rhs ? rhs : old_value, return)            \
     MIN_MAX_CRITSECT(OP, LCK_ID)                                               \
   }                                                                            \
   }
@@ -1257,6 +1457,7 @@ ATOMIC_CMPX_EQV(fixed8, eqv, kmp_int64, 64, ^~, 8i, 7,
 #define ATOMIC_CRITICAL(TYPE_ID, OP_ID, TYPE, OP, LCK_ID, GOMP_FLAG)           \
   ATOMIC_BEGIN(TYPE_ID, OP_ID, TYPE, void)                                     \
   OP_GOMP_CRITICAL(OP## =, GOMP_FLAG) /* send assignment */                    \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = old_value OP rhs, return)             \
   OP_CRITICAL(OP## =, LCK_ID) /* send assignment */                            \
   }
 
@@ -1355,11 +1556,11 @@ ATOMIC_CRITICAL(cmplx16, div_a16, kmp_cmplx128_a16_t, /, 32c,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_REV(OP, LCK_ID)                                            \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   (*lhs) = (rhs)OP(*lhs);                                                      \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);
 
 #ifdef KMP_GOMP_COMPAT
 #define OP_GOMP_CRITICAL_REV(OP, FLAG)                                         \
@@ -1501,6 +1702,7 @@ ATOMIC_CMPXCHG_REV(float8, sub, kmp_real64, 64, -, 8r,
 #define ATOMIC_CRITICAL_REV(TYPE_ID, OP_ID, TYPE, OP, LCK_ID, GOMP_FLAG)       \
   ATOMIC_BEGIN_REV(TYPE_ID, OP_ID, TYPE, void)                                 \
   OP_GOMP_CRITICAL_REV(OP, GOMP_FLAG)                                          \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs OP old_value, return)             \
   OP_CRITICAL_REV(OP, LCK_ID)                                                  \
   }
 
@@ -1577,6 +1779,7 @@ ATOMIC_CRITICAL_REV(cmplx16, div_a16, kmp_cmplx128_a16_t, /, 32c,
                            GOMP_FLAG)                                          \
   ATOMIC_BEGIN_MIX(TYPE_ID, TYPE, OP_ID, RTYPE_ID, RTYPE)                      \
   OP_GOMP_CRITICAL(OP## =, GOMP_FLAG) /* send assignment */                    \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = old_value OP rhs, return)             \
   OP_CRITICAL(OP## =, LCK_ID) /* send assignment */                            \
   }
 
@@ -1620,6 +1823,7 @@ ATOMIC_CRITICAL_REV(cmplx16, div_a16, kmp_cmplx128_a16_t, /, 32c,
                                LCK_ID, GOMP_FLAG)                              \
   ATOMIC_BEGIN_MIX(TYPE_ID, TYPE, OP_ID, RTYPE_ID, RTYPE)                      \
   OP_GOMP_CRITICAL_REV(OP, GOMP_FLAG)                                          \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs OP old_value, return)             \
   OP_CRITICAL_REV(OP, LCK_ID)                                                  \
   }
 #endif /* KMP_ARCH_X86 || KMP_ARCH_X86_64 */
@@ -1901,11 +2105,11 @@ ATOMIC_CMPXCHG_CMPLX(cmplx4, kmp_cmplx32, div, 64, /, cmplx8, kmp_cmplx64, 8c,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_READ(OP, LCK_ID)                                           \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(loc), gtid);                   \
                                                                                \
   new_value = (*loc);                                                          \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(loc), gtid);
 
 // -------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -1944,6 +2148,7 @@ ATOMIC_CMPXCHG_CMPLX(cmplx4, kmp_cmplx32, div, 64, /, cmplx8, kmp_cmplx64, 8c,
   ATOMIC_BEGIN_READ(TYPE_ID, OP_ID, TYPE, TYPE)                                \
   TYPE new_value;                                                              \
   OP_GOMP_CRITICAL_READ(OP## =, GOMP_FLAG) /* send assignment */               \
+  OP_DCAS(TYPE, loc, LCK_ID, new_value = old_value, return old_value)          \
   OP_CRITICAL_READ(OP, LCK_ID) /* send assignment */                           \
   return new_value;                                                            \
   }
@@ -1955,11 +2160,11 @@ ATOMIC_CMPXCHG_CMPLX(cmplx4, kmp_cmplx32, div, 64, /, cmplx8, kmp_cmplx64, 8c,
 #if (KMP_OS_WINDOWS)
 
 #define OP_CRITICAL_READ_WRK(OP, LCK_ID)                                       \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(loc), gtid);                   \
                                                                                \
   (*out) = (*loc);                                                             \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(loc), gtid);
 // ------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
 #define OP_GOMP_CRITICAL_READ_WRK(OP, FLAG)                                    \
@@ -2088,6 +2293,7 @@ ATOMIC_CRITICAL_READ(cmplx16, a16_rd, kmp_cmplx128_a16_t, +, 32c,
 #define ATOMIC_CRITICAL_WR(TYPE_ID, OP_ID, TYPE, OP, LCK_ID, GOMP_FLAG)        \
   ATOMIC_BEGIN(TYPE_ID, OP_ID, TYPE, void)                                     \
   OP_GOMP_CRITICAL(OP, GOMP_FLAG) /* send assignment */                        \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs, return)                          \
   OP_CRITICAL(OP, LCK_ID) /* send assignment */                                \
   }
 // -------------------------------------------------------------------------
@@ -2159,7 +2365,7 @@ ATOMIC_CRITICAL_WR(cmplx16, a16_wr, kmp_cmplx128_a16_t, =, 32c,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_CPT(OP, LCK_ID)                                            \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (flag) {                                                                  \
     (*lhs) OP rhs;                                                             \
@@ -2169,7 +2375,7 @@ ATOMIC_CRITICAL_WR(cmplx16, a16_wr, kmp_cmplx128_a16_t, =, 32c,
     (*lhs) OP rhs;                                                             \
   }                                                                            \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return new_value;
 
 // ------------------------------------------------------------------------
@@ -2385,6 +2591,8 @@ ATOMIC_CMPXCHG_CPT(float8, mul_cpt, kmp_real64, 64, *,
   ATOMIC_BEGIN_CPT_MIX(TYPE_ID, OP_ID, TYPE, RTYPE_ID, RTYPE)                  \
   TYPE new_value;                                                              \
   OP_GOMP_CRITICAL_CPT(OP, GOMP_FLAG) /* send assignment */                    \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = old_value OP rhs,                     \
+          return flag ? new_value : old_value)                                 \
   OP_CRITICAL_CPT(OP## =, LCK_ID) /* send assignment */                        \
   }
 
@@ -2495,14 +2703,14 @@ ATOMIC_CRITICAL_CPT_MIX(float10, long double, div_cpt, /, fp, _Quad, 10r,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_L_CPT(OP, LCK_ID)                                          \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (flag) {                                                                  \
     new_value OP rhs;                                                          \
   } else                                                                       \
     new_value = (*lhs);                                                        \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);
 
 // ------------------------------------------------------------------------
 #ifdef KMP_GOMP_COMPAT
@@ -2552,7 +2760,7 @@ ATOMIC_CMPX_L_CPT(fixed8, orl_cpt, kmp_int64, 64, ||,
 // MIN and MAX need separate macros
 // OP - operator to check if we need any actions?
 #define MIN_MAX_CRITSECT_CPT(OP, LCK_ID)                                       \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (*lhs OP rhs) { /* still need actions? */                                 \
     old_value = *lhs;                                                          \
@@ -2564,7 +2772,7 @@ ATOMIC_CMPX_L_CPT(fixed8, orl_cpt, kmp_int64, 64, ||,
   } else {                                                                     \
     new_value = *lhs;                                                          \
   }                                                                            \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return new_value;
 
 // -------------------------------------------------------------------------
@@ -2607,6 +2815,9 @@ ATOMIC_CMPX_L_CPT(fixed8, orl_cpt, kmp_int64, 64, ||,
   TYPE new_value, old_value;                                                   \
   if (*lhs OP rhs) { /* need actions? */                                       \
     GOMP_MIN_MAX_CRITSECT_CPT(OP, GOMP_FLAG)                                   \
+    OP_DCAS(TYPE, lhs, LCK_ID,                                                 \
+            new_value = old_value OP rhs ? rhs : old_value,                    \
+            return flag ? new_value : old_value)                               \
     MIN_MAX_CRITSECT_CPT(OP, LCK_ID)                                           \
   }                                                                            \
   return *lhs;                                                                 \
@@ -2706,6 +2917,8 @@ ATOMIC_CMPX_EQV_CPT(fixed8, eqv_cpt, kmp_int64, 64, ^~,
   ATOMIC_BEGIN_CPT(TYPE_ID, OP_ID, TYPE, TYPE)                                 \
   TYPE new_value;                                                              \
   OP_GOMP_CRITICAL_CPT(OP, GOMP_FLAG) /* send assignment */                    \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = old_value OP rhs,                     \
+          return flag ? new_value : old_value)                                 \
   OP_CRITICAL_CPT(OP## =, LCK_ID) /* send assignment */                        \
   }
 
@@ -2713,7 +2926,7 @@ ATOMIC_CMPX_EQV_CPT(fixed8, eqv_cpt, kmp_int64, 64, ^~,
 // Workaround for cmplx4. Regular routines with return value don't work
 // on Win_32e. Let's return captured values through the additional parameter.
 #define OP_CRITICAL_CPT_WRK(OP, LCK_ID)                                        \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (flag) {                                                                  \
     (*lhs) OP rhs;                                                             \
@@ -2723,7 +2936,7 @@ ATOMIC_CMPX_EQV_CPT(fixed8, eqv_cpt, kmp_int64, 64, ^~,
     (*lhs) OP rhs;                                                             \
   }                                                                            \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return;
 // ------------------------------------------------------------------------
 
@@ -2844,7 +3057,7 @@ ATOMIC_CRITICAL_CPT(cmplx16, div_a16_cpt, kmp_cmplx128_a16_t, /, 32c,
 // Note: don't check gtid as it should always be valid
 // 1, 2-byte - expect valid parameter, other - check before this macro
 #define OP_CRITICAL_CPT_REV(OP, LCK_ID)                                        \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (flag) {                                                                  \
     /*temp_val = (*lhs);*/                                                     \
@@ -2854,7 +3067,7 @@ ATOMIC_CRITICAL_CPT(cmplx16, div_a16_cpt, kmp_cmplx128_a16_t, /, 32c,
     new_value = (*lhs);                                                        \
     (*lhs) = (rhs)OP(*lhs);                                                    \
   }                                                                            \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return new_value;
 
 // ------------------------------------------------------------------------
@@ -2974,6 +3187,8 @@ ATOMIC_CMPXCHG_CPT_REV(float8, sub_cpt_rev, kmp_real64, 64, -,
   TYPE new_value;                                                              \
   /*printf("__kmp_atomic_mode = %d\n", __kmp_atomic_mode);*/                   \
   OP_GOMP_CRITICAL_CPT_REV(OP, GOMP_FLAG)                                      \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs OP old_value,                     \
+          return flag ? new_value : old_value)                                 \
   OP_CRITICAL_CPT_REV(OP, LCK_ID)                                              \
   }
 
@@ -3003,7 +3218,7 @@ ATOMIC_CRITICAL_CPT_REV(float16, div_a16_cpt_rev, Quad_a16_t, /, 16r,
 // Workaround for cmplx4. Regular routines with return value don't work
 // on Win_32e. Let's return captured values through the additional parameter.
 #define OP_CRITICAL_CPT_REV_WRK(OP, LCK_ID)                                    \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   if (flag) {                                                                  \
     (*lhs) = (rhs)OP(*lhs);                                                    \
@@ -3013,7 +3228,7 @@ ATOMIC_CRITICAL_CPT_REV(float16, div_a16_cpt_rev, Quad_a16_t, /, 16r,
     (*lhs) = (rhs)OP(*lhs);                                                    \
   }                                                                            \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return;
 // ------------------------------------------------------------------------
 
@@ -3087,6 +3302,8 @@ ATOMIC_CRITICAL_CPT_REV(cmplx16, div_a16_cpt_rev, kmp_cmplx128_a16_t, /, 32c,
   ATOMIC_BEGIN_CPT_MIX(TYPE_ID, OP_ID, TYPE, RTYPE_ID, RTYPE)                  \
   TYPE new_value;                                                              \
   OP_GOMP_CRITICAL_CPT_REV(OP, GOMP_FLAG) /* send assignment */                \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs OP old_value,                     \
+          return flag ? new_value : old_value)                                 \
   OP_CRITICAL_CPT_REV(OP, LCK_ID) /* send assignment */                        \
   }
 
@@ -3162,12 +3379,12 @@ ATOMIC_CRITICAL_CPT_REV_MIX(float10, long double, div_cpt_rev, /, fp, _Quad,
     KA_TRACE(100, ("__kmpc_atomic_" #TYPE_ID "_swp: T#%d\n", gtid));
 
 #define CRITICAL_SWP(LCK_ID)                                                   \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   old_value = (*lhs);                                                          \
   (*lhs) = rhs;                                                                \
                                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return old_value;
 
 // ------------------------------------------------------------------------
@@ -3250,6 +3467,7 @@ ATOMIC_XCHG_FLOAT_SWP(float8, kmp_real64, 64,
   ATOMIC_BEGIN_SWP(TYPE_ID, TYPE)                                              \
   TYPE old_value;                                                              \
   GOMP_CRITICAL_SWP(GOMP_FLAG)                                                 \
+  OP_DCAS(TYPE, lhs, LCK_ID, new_value = rhs, return old_value)                \
   CRITICAL_SWP(LCK_ID)                                                         \
   }
 
@@ -3265,12 +3483,12 @@ ATOMIC_XCHG_FLOAT_SWP(float8, kmp_real64, 64,
     KA_TRACE(100, ("__kmpc_atomic_" #TYPE_ID "_swp: T#%d\n", gtid));
 
 #define CRITICAL_SWP_WRK(LCK_ID)                                               \
-  __kmp_acquire_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_acquire_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
                                                                                \
   tmp = (*lhs);                                                                \
   (*lhs) = (rhs);                                                              \
   (*out) = tmp;                                                                \
-  __kmp_release_atomic_lock(&ATOMIC_LOCK##LCK_ID, gtid);                       \
+  __kmp_release_atomic_lock(ATOMIC_LOCK##LCK_ID(lhs), gtid);                   \
   return;
 // ------------------------------------------------------------------------
 
@@ -3358,7 +3576,7 @@ void __kmpc_atomic_1(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_acquire_atomic_lock(&__kmp_atomic_lock_1i, gtid);
+      __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
     (*f)(lhs, lhs, rhs);
 
@@ -3367,7 +3585,7 @@ void __kmpc_atomic_1(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_release_atomic_lock(&__kmp_atomic_lock_1i, gtid);
+      __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
   }
 }
 
@@ -3405,7 +3623,7 @@ void __kmpc_atomic_2(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_acquire_atomic_lock(&__kmp_atomic_lock_2i, gtid);
+      __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
     (*f)(lhs, lhs, rhs);
 
@@ -3414,7 +3632,7 @@ void __kmpc_atomic_2(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_release_atomic_lock(&__kmp_atomic_lock_2i, gtid);
+      __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
   }
 }
 
@@ -3447,7 +3665,7 @@ void __kmpc_atomic_4(ident_t *id_ref, int gtid, void *lhs, void *rhs,
 
     return;
   } else {
-// Use __kmp_atomic_lock_4i for all 4-byte data,
+// Use the lock of the address for all 4-byte data,
 // even if it isn't of integer data type.
 
 #ifdef KMP_GOMP_COMPAT
@@ -3455,7 +3673,7 @@ void __kmpc_atomic_4(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_acquire_atomic_lock(&__kmp_atomic_lock_4i, gtid);
+      __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
     (*f)(lhs, lhs, rhs);
 
@@ -3464,7 +3682,7 @@ void __kmpc_atomic_4(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_release_atomic_lock(&__kmp_atomic_lock_4i, gtid);
+      __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
   }
 }
 
@@ -3496,7 +3714,7 @@ void __kmpc_atomic_8(ident_t *id_ref, int gtid, void *lhs, void *rhs,
 
     return;
   } else {
-// Use __kmp_atomic_lock_8i for all 8-byte data,
+// Use the lock of the address for all 8-byte data,
 // even if it isn't of integer data type.
 
 #ifdef KMP_GOMP_COMPAT
@@ -3504,7 +3722,7 @@ void __kmpc_atomic_8(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_acquire_atomic_lock(&__kmp_atomic_lock_8i, gtid);
+      __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
     (*f)(lhs, lhs, rhs);
 
@@ -3513,7 +3731,7 @@ void __kmpc_atomic_8(ident_t *id_ref, int gtid, void *lhs, void *rhs,
       __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
     } else
 #endif /* KMP_GOMP_COMPAT */
-      __kmp_release_atomic_lock(&__kmp_atomic_lock_8i, gtid);
+      __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
   }
 }
 
@@ -3526,7 +3744,7 @@ void __kmpc_atomic_10(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock(&__kmp_atomic_lock_10r, gtid);
+    __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
   (*f)(lhs, lhs, rhs);
 
@@ -3535,7 +3753,7 @@ void __kmpc_atomic_10(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock(&__kmp_atomic_lock_10r, gtid);
+    __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 }
 
 void __kmpc_atomic_16(ident_t *id_ref, int gtid, void *lhs, void *rhs,
@@ -3547,7 +3765,22 @@ void __kmpc_atomic_16(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock(&__kmp_atomic_lock_16c, gtid);
+#if KMP_HAVE_CMPXCHG16B
+      if (KMP_ATOMIC_DCAS(16c, lhs)) {
+    kmp_int64 old_value[2], new_value[2];
+
+    old_value[0] = ((volatile kmp_int64 *)lhs)[0];
+    old_value[1] = ((volatile kmp_int64 *)lhs)[1];
+    (*f)(new_value, old_value, rhs);
+    while (!__kmp_compare_and_store128((volatile kmp_int64 *)lhs, old_value,
+                                       new_value)) {
+      KMP_CPU_PAUSE();
+      (*f)(new_value, old_value, rhs);
+    }
+    return;
+  } else
+#endif // KMP_HAVE_CMPXCHG16B
+    __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
   (*f)(lhs, lhs, rhs);
 
@@ -3556,7 +3789,7 @@ void __kmpc_atomic_16(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock(&__kmp_atomic_lock_16c, gtid);
+    __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 }
 
 void __kmpc_atomic_20(ident_t *id_ref, int gtid, void *lhs, void *rhs,
@@ -3568,7 +3801,7 @@ void __kmpc_atomic_20(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock(&__kmp_atomic_lock_20c, gtid);
+    __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
   (*f)(lhs, lhs, rhs);
 
@@ -3577,7 +3810,7 @@ void __kmpc_atomic_20(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock(&__kmp_atomic_lock_20c, gtid);
+    __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 }
 
 void __kmpc_atomic_32(ident_t *id_ref, int gtid, void *lhs, void *rhs,
@@ -3589,7 +3822,7 @@ void __kmpc_atomic_32(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_acquire_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_acquire_atomic_lock(&__kmp_atomic_lock_32c, gtid);
+    __kmp_acquire_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 
   (*f)(lhs, lhs, rhs);
 
@@ -3598,7 +3831,7 @@ void __kmpc_atomic_32(ident_t *id_ref, int gtid, void *lhs, void *rhs,
     __kmp_release_atomic_lock(&__kmp_atomic_lock, gtid);
   } else
 #endif /* KMP_GOMP_COMPAT */
-    __kmp_release_atomic_lock(&__kmp_atomic_lock_32c, gtid);
+    __kmp_release_atomic_lock(__kmp_atomic_lock_of(lhs), gtid);
 }
 
 // AC: same two routines as GOMP_atomic_start/end, but will be called by our
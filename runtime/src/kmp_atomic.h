@@ -354,6 +354,7 @@ extern "C" {
 #endif
 
 extern int __kmp_atomic_mode;
+extern int __kmp_atomic_combine; // failed CASes before combining, 0 - never
 
 // Atomic locks can easily become contended, so we use queuing locks for them.
 typedef kmp_queuing_lock_t kmp_atomic_lock_t;
@@ -404,43 +405,27 @@ static inline void __kmp_destroy_atomic_lock(kmp_atomic_lock_t *lck) {
 
 // Global Locks
 extern kmp_atomic_lock_t __kmp_atomic_lock; /* Control access to all user coded
-                                               atomics in Gnu compat mode   */
-extern kmp_atomic_lock_t __kmp_atomic_lock_1i; /* Control access to all user
-                                                  coded atomics for 1-byte fixed
-                                                  data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_2i; /* Control access to all user
-                                                  coded atomics for 2-byte fixed
-                                                  data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_4i; /* Control access to all user
-                                                  coded atomics for 4-byte fixed
-                                                  data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_4r; /* Control access to all user
-                                                  coded atomics for kmp_real32
-                                                  data type    */
-extern kmp_atomic_lock_t __kmp_atomic_lock_8i; /* Control access to all user
-                                                  coded atomics for 8-byte fixed
-                                                  data types */
-extern kmp_atomic_lock_t __kmp_atomic_lock_8r; /* Control access to all user
-                                                  coded atomics for kmp_real64
-                                                  data type    */
-extern kmp_atomic_lock_t
-    __kmp_atomic_lock_8c; /* Control access to all user coded atomics for
-                             complex byte data type  */
-extern kmp_atomic_lock_t
-    __kmp_atomic_lock_10r; /* Control access to all user coded atomics for long
-                              double data type   */
-extern kmp_atomic_lock_t __kmp_atomic_lock_16r; /* Control access to all user
-                                                   coded atomics for _Quad data
-                                                   type         */
-extern kmp_atomic_lock_t __kmp_atomic_lock_16c; /* Control access to all user
-                                                   coded atomics for double
-                                                   complex data type*/
-extern kmp_atomic_lock_t
-    __kmp_atomic_lock_20c; /* Control access to all user coded atomics for long
-                              double complex type*/
-extern kmp_atomic_lock_t __kmp_atomic_lock_32c; /* Control access to all user
-                                                   coded atomics for _Quad
-                                                   complex data type */
+                                               atomics in Gnu compat mode and
+                                               from __kmpc_atomic_start() */
+
+// Locks for the user coded atomics without a native implementation outside of
+// Gnu compat mode. Updates to different cache lines mostly take different
+// locks, instead of one lock per data type serializing all of them.
+#define KMP_ATOMIC_LOCK_BITS 6
+#define KMP_ATOMIC_LOCKS (1 << KMP_ATOMIC_LOCK_BITS)
+extern kmp_atomic_lock_t __kmp_atomic_locks[KMP_ATOMIC_LOCKS];
+
+static inline int __kmp_atomic_stripe(void *addr) {
+  // Fibonacci hashing of the cache line address
+  kmp_uint64 line = (kmp_uint64)((kmp_uintptr_t)addr / CACHE_LINE);
+  return (int)((line * 0x9E3779B97F4A7C15ULL) >> (64 - KMP_ATOMIC_LOCK_BITS));
+}
+
+static inline kmp_atomic_lock_t *__kmp_atomic_lock_of(void *addr) {
+  return &__kmp_atomic_locks[__kmp_atomic_stripe(addr)];
+}
+
+extern void __kmp_cleanup_atomic_combine(void);
 
 //  Below routines for atomic UPDATE are listed
 
@@ -174,14 +174,11 @@ static bool __kmp_linear_barrier_release_template(
       {
         KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(USER_icv_copy);
         if (propagate_icvs) {
-          ngo_load(&team->t.t_implicit_task_taskdata[0].td_icvs);
+          // Workers pull the ICVs themselves in __kmp_fork_barrier()
           for (i = 1; i < nproc; ++i) {
             __kmp_init_implicit_task(team->t.t_ident, team->t.t_threads[i],
                                      team, i, FALSE);
-            ngo_store_icvs(&team->t.t_implicit_task_taskdata[i].td_icvs,
-                           &team->t.t_implicit_task_taskdata[0].td_icvs);
           }
-          ngo_sync();
         }
       }
 #endif // KMP_BARRIER_ICV_PUSH
@@ -481,8 +478,6 @@ static void __kmp_tree_barrier_release(
           __kmp_init_implicit_task(team->t.t_ident,
                                    team->t.t_threads[child_tid], team,
                                    child_tid, FALSE);
-          copy_icvs(&team->t.t_implicit_task_taskdata[child_tid].td_icvs,
-                    &team->t.t_implicit_task_taskdata[0].td_icvs);
         }
       }
 #endif // KMP_BARRIER_ICV_PUSH
@@ -651,12 +646,6 @@ static void __kmp_hyper_barrier_release(
     KA_TRACE(20, ("__kmp_hyper_barrier_release: T#%d(%d:%d) master enter for "
                   "barrier type %d\n",
                   gtid, team->t.t_id, tid, bt));
-#if KMP_BARRIER_ICV_PUSH
-    if (propagate_icvs) { // master already has ICVs in final destination; copy
-      copy_icvs(&thr_bar->th_fixed_icvs,
-                &team->t.t_implicit_task_taskdata[tid].td_icvs);
-    }
-#endif
   } else { // Handle fork barrier workers who aren't part of a team yet
     KA_TRACE(20, ("__kmp_hyper_barrier_release: T#%d wait go(%p) == %u\n", gtid,
                   &thr_bar->b_go, KMP_BARRIER_STATE_BUMP));
@@ -749,11 +738,6 @@ static void __kmp_hyper_barrier_release(
               &other_threads[next_child_tid]->th.th_bar[bt].bb.b_go);
 #endif /* KMP_CACHE_MANAGE */
 
-#if KMP_BARRIER_ICV_PUSH
-        if (propagate_icvs) // push my fixed ICVs to my child
-          copy_icvs(&child_bar->th_fixed_icvs, &thr_bar->th_fixed_icvs);
-#endif // KMP_BARRIER_ICV_PUSH
-
         KA_TRACE(
             20,
             ("__kmp_hyper_barrier_release: T#%d(%d:%d) releasing T#%d(%d:%u)"
@@ -769,12 +753,10 @@ static void __kmp_hyper_barrier_release(
     }
   }
 #if KMP_BARRIER_ICV_PUSH
-  if (propagate_icvs &&
-      !KMP_MASTER_TID(tid)) { // copy ICVs locally to final dest
+  if (propagate_icvs && !KMP_MASTER_TID(tid)) {
+    // ICVs are pulled from the team in __kmp_fork_barrier()
     __kmp_init_implicit_task(team->t.t_ident, team->t.t_threads[tid], team, tid,
                              FALSE);
-    copy_icvs(&team->t.t_implicit_task_taskdata[tid].td_icvs,
-              &thr_bar->th_fixed_icvs);
   }
 #endif
   KA_TRACE(
@@ -1589,6 +1571,86 @@ int __kmp_barrier(enum barrier_type bt, int gtid, int is_split,
                                   reduce);
 }
 
+/* Gather-only reduction barrier used by __kmpc_reduce() when the barrier that
+   terminates the construct is fused with the compiler-generated barrier that
+   follows __kmpc_end_reduce() (KMP_FUSED_REDUCTION_BARRIER).  Each parent
+   combines its children's reduce_data in place exactly as __kmp_barrier()
+   does, but there is no release phase: a worker leaves as soon as its subtree
+   has been combined and handed to its parent.  Its reduce_data stays valid
+   because the worker cannot get past the following barrier until the master
+   has finished the gather.  The tasking barrier protocol is left to that
+   barrier as well.
+   Returns 0 if master thread, 1 if worker thread.  */
+int __kmp_barrier_gather_reduce(enum barrier_type bt, int gtid,
+                                size_t reduce_size, void *reduce_data,
+                                void (*reduce)(void *, void *)) {
+  KMP_TIME_PARTITIONED_BLOCK(OMP_plain_barrier);
+  KMP_SET_THREAD_STATE_BLOCK(PLAIN_BARRIER);
+  int tid = __kmp_tid_from_gtid(gtid);
+  kmp_info_t *this_thr = __kmp_threads[gtid];
+  kmp_team_t *team = this_thr->th.th_team;
+
+  KMP_DEBUG_ASSERT(reduce != NULL);
+  KMP_DEBUG_ASSERT(__kmp_barrier_gather_pattern[bt] != bp_hierarchical_bar);
+  KA_TRACE(15, ("__kmp_barrier_gather_reduce: T#%d(%d:%d) has arrived\n",
+                gtid, team->t.t_id, tid));
+
+  if (team->t.t_serialized) {
+    KA_TRACE(15, ("__kmp_barrier_gather_reduce: T#%d serialized team\n", gtid));
+    return 0;
+  }
+
+  ANNOTATE_BARRIER_BEGIN(&team->t.t_bar);
+#if USE_ITT_BUILD
+  void *itt_sync_obj = NULL;
+#endif
+#if OMPT_SUPPORT
+  ompt_state_t ompt_state = this_thr->th.ompt_thread_info.state;
+  if (ompt_enabled.enabled)
+    this_thr->th.ompt_thread_info.state = ompt_state_wait_barrier;
+#endif
+  if (__kmp_dflt_blocktime != KMP_MAX_BLOCKTIME) {
+#if KMP_USE_MONITOR
+    this_thr->th.th_team_bt_intervals =
+        team->t.t_implicit_task_taskdata[tid].td_icvs.bt_intervals;
+    this_thr->th.th_team_bt_set =
+        team->t.t_implicit_task_taskdata[tid].td_icvs.bt_set;
+#else
+    this_thr->th.th_team_bt_intervals = KMP_BLOCKTIME_INTERVAL(team, tid);
+#endif
+  }
+  this_thr->th.th_local.reduce_data = reduce_data;
+
+  switch (__kmp_barrier_gather_pattern[bt]) {
+  case bp_hyper_bar: {
+    KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]);
+    __kmp_hyper_barrier_gather(bt, this_thr, gtid, tid,
+                               reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+    break;
+  }
+  case bp_tree_bar: {
+    KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]);
+    __kmp_tree_barrier_gather(bt, this_thr, gtid, tid,
+                              reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+    break;
+  }
+  default: {
+    __kmp_linear_barrier_gather(bt, this_thr, gtid, tid,
+                                reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+  }
+  }
+  KMP_MB();
+
+#if OMPT_SUPPORT
+  if (ompt_enabled.enabled)
+    this_thr->th.ompt_thread_info.state = ompt_state;
+#endif
+  ANNOTATE_BARRIER_END(&team->t.t_bar);
+  KA_TRACE(15, ("__kmp_barrier_gather_reduce: T#%d(%d) is leaving\n", gtid,
+                tid));
+  return KMP_MASTER_TID(tid) ? 0 : 1;
+}
+
 #if defined(KMP_GOMP_COMPAT)
 // Returns 1 if cancelled, 0 otherwise
 int __kmp_barrier_gomp_cancel(int gtid) {
@@ -1888,6 +1950,38 @@ void __kmp_join_barrier(int gtid) {
   ANNOTATE_BARRIER_END(&team->t.t_bar);
 }
 
+#if KMP_BARRIER_ICV_PUSH
+/* With the linear, tree and hyper release patterns the master publishes its
+   ICVs once in the team's ICV block and each worker copies them into its own
+   implicit task. The version only changes when the ICVs do, so in the common
+   case no ICV cache line is written at all. The hierarchical barrier keeps
+   piggybacking the ICVs on its b_go cache line. */
+static inline bool __kmp_icv_pull_enabled() {
+  return __kmp_barrier_release_pattern[bs_forkjoin_barrier] !=
+         bp_hierarchical_bar;
+}
+
+static void __kmp_publish_team_icvs(kmp_team_t *team) {
+  kmp_internal_control_t *icvs = &team->t.t_implicit_task_taskdata[0].td_icvs;
+  if (team->t.t_icv_version == 0 || !same_icvs(&team->t.t_icvs, icvs)) {
+    copy_icvs(&team->t.t_icvs, icvs);
+    if (++team->t.t_icv_version == 0) // 0 is reserved for changed copies
+      team->t.t_icv_version = 1;
+    KA_TRACE(20, ("__kmp_publish_team_icvs: team %d ICV version %u\n",
+                  team->t.t_id, team->t.t_icv_version));
+  }
+}
+
+static void __kmp_pull_team_icvs(kmp_team_t *team, int tid) {
+  kmp_taskdata_t *task = &team->t.t_implicit_task_taskdata[tid];
+  kmp_uint32 version = team->t.t_icv_version;
+  if (task->td_icv_version != version) {
+    copy_icvs(&task->td_icvs, &team->t.t_icvs);
+    task->td_icv_version = version;
+  }
+}
+#endif // KMP_BARRIER_ICV_PUSH
+
 // TODO release worker threads' fork barriers as we are ready instead of all at
 // once
 void __kmp_fork_barrier(int gtid, int tid) {
@@ -1956,6 +2050,10 @@ void __kmp_fork_barrier(int gtid, int tid) {
       this_thr->th.th_team_bt_intervals = KMP_BLOCKTIME_INTERVAL(team, tid);
 #endif
     }
+#if KMP_BARRIER_ICV_PUSH
+    if (__kmp_icv_pull_enabled())
+      __kmp_publish_team_icvs(team);
+#endif
   } // master
 
   switch (__kmp_barrier_release_pattern[bs_forkjoin_barrier]) {
@@ -2061,6 +2159,11 @@ void __kmp_fork_barrier(int gtid, int tid) {
                      .bb.th_fixed_icvs);
     }
   }
+#elif KMP_BARRIER_ICV_PUSH
+  if (!KMP_MASTER_TID(tid) && __kmp_icv_pull_enabled()) {
+    KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(USER_icv_copy);
+    __kmp_pull_team_icvs(team, tid);
+  }
 #endif // KMP_BARRIER_ICV_PULL
 
   if (__kmp_tasking_mode != tskm_immediate_exec) {
@@ -447,6 +447,7 @@ void __kmpc_fork_teams(ident_t *loc, kmp_int32 argc, kmpc_micro microtask,
   KMP_DEBUG_ASSERT(this_thr->th.th_cg_roots);
   this_thr->th.th_current_task->td_icvs.thread_limit =
       this_thr->th.th_cg_roots->cg_thread_limit;
+  KMP_ICVS_CHANGED(this_thr->th.th_current_task);
 
   this_thr->th.th_teams_microtask = NULL;
   this_thr->th.th_teams_level = 0;
@@ -1296,9 +1297,13 @@ static __forceinline kmp_dyna_lockseq_t __kmp_map_hint_to_lock(uintptr_t hint) {
       (hint & omp_lock_hint_nonspeculative))
     return __kmp_user_lock_seq;
 
-  // Do not even consider speculation when it appears to be contended
+  if (hint & kmp_lock_hint_cohort)
+    return lockseq_cohort;
+
+  // Do not even consider speculation when it appears to be contended; keep
+  // the lock traffic within a node when there is more than one
   if (hint & omp_lock_hint_contended)
-    return lockseq_queuing;
+    return __kmp_cohort_num_nodes() > 1 ? lockseq_cohort : lockseq_queuing;
 
   // Uncontended lock without speculation
   if ((hint & omp_lock_hint_uncontended) && !(hint & omp_lock_hint_speculative))
@@ -1341,6 +1346,7 @@ __ompt_get_mutex_impl_type(void *user_lock, kmp_indirect_lock_t *ilock = 0) {
   case locktag_rtm:
     return kmp_mutex_impl_speculative;
 #endif
+  case locktag_rw:
   case locktag_nested_tas:
     return kmp_mutex_impl_spin;
 #if KMP_USE_FUTEX
@@ -1349,6 +1355,8 @@ __ompt_get_mutex_impl_type(void *user_lock, kmp_indirect_lock_t *ilock = 0) {
   case locktag_ticket:
   case locktag_queuing:
   case locktag_drdpa:
+  case locktag_cohort:
+  case locktag_hybrid:
   case locktag_nested_ticket:
   case locktag_nested_queuing:
   case locktag_nested_drdpa:
@@ -2009,6 +2017,18 @@ void kmpc_set_disp_num_buffers(int arg) {
     __kmp_dispatch_num_buffers = arg;
 }
 
+// Prints the n most contended lock sites profiled with KMP_LOCK_PROFILE, all
+// of them if n <= 0.
+void kmpc_print_lock_profile(int n) {
+#if KMP_USE_DYNAMIC_LOCK
+  int gtid = __kmp_entry_gtid();
+  // the profiles of destroyed locks only change under the global lock
+  __kmp_acquire_lock(&__kmp_global_lock, gtid);
+  __kmp_print_lock_profile(n);
+  __kmp_release_lock(&__kmp_global_lock, gtid);
+#endif
+}
+
 int kmpc_set_affinity_mask_proc(int proc, void **mask) {
 #if defined(KMP_STUB) || !KMP_AFFINITY_SUPPORTED
   return -1;
@@ -2220,12 +2240,85 @@ __kmp_init_nest_lock_with_hint(ident_t *loc, void **lock,
     seq = lockseq_nested_queuing;
   }
   KMP_INIT_I_LOCK(lock, seq);
+  if (KMP_NEST_LOCK_HAS_OWNER_WORD)
+    *KMP_NEST_LOCK_OWNER_WORD(lock) = 0;
 #if USE_ITT_BUILD
   kmp_indirect_lock_t *ilk = KMP_LOOKUP_I_LOCK(lock);
   __kmp_itt_lock_creating(ilk->lock, loc);
 #endif
 }
 
+// The owner word is not used while lock profiling counts every acquisition.
+#define KMP_USE_NEST_LOCK_OWNER_WORD                                           \
+  (KMP_NEST_LOCK_HAS_OWNER_WORD && !__kmp_lock_profile)
+
+// Nested lock acquisition: the owner only counts the level in the owner word,
+// other threads acquire the indirect lock and then record themselves there.
+static __forceinline int __kmp_acquire_nest_lock(void **lock, kmp_int32 gtid) {
+  if (KMP_USE_NEST_LOCK_OWNER_WORD && gtid >= 0) {
+    volatile kmp_uint32 *word = KMP_NEST_LOCK_OWNER_WORD(lock);
+    kmp_uint32 w = *word;
+    if (KMP_NEST_LOCK_OWNER(w) == (kmp_uint32)(gtid + 1)) {
+      if ((w & KMP_NEST_LOCK_DEPTH_MASK) != KMP_NEST_LOCK_DEPTH_MASK) {
+        *word = w + 1;
+        return KMP_LOCK_ACQUIRED_NEXT;
+      }
+      *word = w | KMP_NEST_LOCK_SPILLED;
+    }
+    int status = KMP_D_LOCK_FUNC(lock, set)((kmp_dyna_lock_t *)lock, gtid);
+    if (status == KMP_LOCK_ACQUIRED_FIRST && gtid < KMP_NEST_LOCK_MAX_OWNER)
+      *word = KMP_NEST_LOCK_WORD(gtid, 1);
+    return status;
+  }
+  return KMP_D_LOCK_FUNC(lock, set)((kmp_dyna_lock_t *)lock, gtid);
+}
+
+// Nested lock test, returns the new depth or 0 like the indirect locks do.
+static __forceinline int __kmp_test_nest_lock(void **lock, kmp_int32 gtid) {
+  if (KMP_USE_NEST_LOCK_OWNER_WORD && gtid >= 0) {
+    volatile kmp_uint32 *word = KMP_NEST_LOCK_OWNER_WORD(lock);
+    kmp_uint32 w = *word;
+    int depth = w & KMP_NEST_LOCK_DEPTH_MASK;
+    if (KMP_NEST_LOCK_OWNER(w) == (kmp_uint32)(gtid + 1)) {
+      if (!(w & KMP_NEST_LOCK_SPILLED) && depth != KMP_NEST_LOCK_DEPTH_MASK) {
+        *word = w + 1;
+        return depth + 1;
+      }
+      // The indirect lock counts the first level and the spilled ones
+      *word = w | KMP_NEST_LOCK_SPILLED;
+      return depth - 1 +
+             KMP_D_LOCK_FUNC(lock, test)((kmp_dyna_lock_t *)lock, gtid);
+    }
+    int rc = KMP_D_LOCK_FUNC(lock, test)((kmp_dyna_lock_t *)lock, gtid);
+    if (rc && gtid < KMP_NEST_LOCK_MAX_OWNER)
+      *word = KMP_NEST_LOCK_WORD(gtid, 1);
+    return rc;
+  }
+  return KMP_D_LOCK_FUNC(lock, test)((kmp_dyna_lock_t *)lock, gtid);
+}
+
+// Nested lock release: the owner clears the owner word before it releases the
+// indirect lock and restores it if spilled levels keep the lock held.
+static __forceinline int __kmp_release_nest_lock(void **lock, kmp_int32 gtid) {
+  if (KMP_USE_NEST_LOCK_OWNER_WORD && gtid >= 0) {
+    volatile kmp_uint32 *word = KMP_NEST_LOCK_OWNER_WORD(lock);
+    kmp_uint32 w = *word;
+    if (KMP_NEST_LOCK_OWNER(w) == (kmp_uint32)(gtid + 1)) {
+      if ((w & KMP_NEST_LOCK_DEPTH_MASK) > 1) {
+        *word = w - 1;
+        return KMP_LOCK_STILL_HELD;
+      }
+      *word = 0;
+      int status =
+          KMP_D_LOCK_FUNC(lock, unset)((kmp_dyna_lock_t *)lock, gtid);
+      if (status == KMP_LOCK_STILL_HELD)
+        *word = w;
+      return status;
+    }
+  }
+  return KMP_D_LOCK_FUNC(lock, unset)((kmp_dyna_lock_t *)lock, gtid);
+}
+
 /* initialize the lock with a hint */
 void __kmpc_init_lock_with_hint(ident_t *loc, kmp_int32 gtid, void **user_lock,
                                 uintptr_t hint) {
@@ -2688,8 +2781,7 @@ void __kmpc_set_nest_lock(ident_t *loc, kmp_int32 gtid, void **user_lock) {
     }
   }
 #endif
-  int acquire_status =
-      KMP_D_LOCK_FUNC(user_lock, set)((kmp_dyna_lock_t *)user_lock, gtid);
+  int acquire_status = __kmp_acquire_nest_lock(user_lock, gtid);
   (void) acquire_status;
 #if USE_ITT_BUILD
   __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
@@ -2881,8 +2973,7 @@ void __kmpc_unset_nest_lock(ident_t *loc, kmp_int32 gtid, void **user_lock) {
 #if USE_ITT_BUILD
   __kmp_itt_lock_releasing((kmp_user_lock_p)user_lock);
 #endif
-  int release_status =
-      KMP_D_LOCK_FUNC(user_lock, unset)((kmp_dyna_lock_t *)user_lock, gtid);
+  int release_status = __kmp_release_nest_lock(user_lock, gtid);
   (void) release_status;
 
 #if OMPT_SUPPORT && OMPT_OPTIONAL
@@ -3127,7 +3218,7 @@ int __kmpc_test_nest_lock(ident_t *loc, kmp_int32 gtid, void **user_lock) {
         (ompt_wait_id_t)(uintptr_t)user_lock, codeptr);
   }
 #endif
-  rc = KMP_D_LOCK_FUNC(user_lock, test)((kmp_dyna_lock_t *)user_lock, gtid);
+  rc = __kmp_test_nest_lock(user_lock, gtid);
 #if USE_ITT_BUILD
   if (rc) {
     __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
@@ -3226,6 +3317,211 @@ int __kmpc_test_nest_lock(ident_t *loc, kmp_int32 gtid, void **user_lock) {
 #endif // KMP_USE_DYNAMIC_LOCK
 }
 
+// Reader-writer locks. Any number of threads hold the lock for reading at a
+// time, or a single thread holds it for writing. The write functions go
+// through the regular lock entries; without dynamic locks the read functions
+// take the lock exclusively as well.
+#if KMP_USE_DYNAMIC_LOCK
+// Returns the lock object of a lock initialized with kmpc_init_rw_lock.
+static kmp_rw_lock_t *__kmp_lookup_rw_lock(void **user_lock,
+                                           char const *func) {
+  kmp_indirect_lock_t *ilock = NULL;
+  if (user_lock != NULL && KMP_EXTRACT_D_TAG(user_lock) == 0)
+    ilock = KMP_LOOKUP_I_LOCK(user_lock);
+  // Without consistency checks only a lock that is not there at all is
+  // caught, instead of dereferencing NULL
+  if (ilock == NULL ||
+      (__kmp_env_consistency_check && ilock->type != locktag_rw)) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  return (kmp_rw_lock_t *)ilock->lock;
+}
+#endif
+
+void kmpc_init_rw_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_entry_gtid(); // initializes the library and the lock table if needed
+  if (__kmp_env_consistency_check && user_lock == NULL) {
+    KMP_FATAL(LockIsUninitialized, "kmpc_init_rw_lock");
+  }
+  __kmp_init_lock_with_hint(NULL, user_lock, lockseq_rw);
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  if (ompt_enabled.ompt_callback_lock_init) {
+    ompt_callbacks.ompt_callback(ompt_callback_lock_init)(
+        ompt_mutex_lock, omp_lock_hint_none,
+        __ompt_get_mutex_impl_type(user_lock),
+        (ompt_wait_id_t)(uintptr_t)user_lock, OMPT_GET_RETURN_ADDRESS(0));
+  }
+#endif
+#else
+  int gtid = __kmp_entry_gtid();
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_init_lock(NULL, gtid, user_lock);
+#endif // KMP_USE_DYNAMIC_LOCK
+}
+
+void kmpc_destroy_rw_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_lookup_rw_lock(user_lock, "kmpc_destroy_rw_lock");
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_destroy_lock(NULL, gtid, user_lock);
+}
+
+void kmpc_set_wr_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_lookup_rw_lock(user_lock, "kmpc_set_wr_lock");
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_set_lock(NULL, gtid, user_lock);
+}
+
+void kmpc_unset_wr_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_lookup_rw_lock(user_lock, "kmpc_unset_wr_lock");
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_unset_lock(NULL, gtid, user_lock);
+}
+
+int kmpc_test_wr_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_lookup_rw_lock(user_lock, "kmpc_test_wr_lock");
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  return __kmpc_test_lock(NULL, gtid, user_lock);
+}
+
+void kmpc_set_rd_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  kmp_rw_lock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmpc_set_rd_lock");
+#if USE_ITT_BUILD
+  __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  void *codeptr = OMPT_GET_RETURN_ADDRESS(0);
+  if (ompt_enabled.ompt_callback_mutex_acquire) {
+    ompt_callbacks.ompt_callback(ompt_callback_mutex_acquire)(
+        ompt_mutex_lock, omp_lock_hint_none,
+        __ompt_get_mutex_impl_type(user_lock),
+        (ompt_wait_id_t)(uintptr_t)user_lock, codeptr);
+  }
+#endif
+  if (__kmp_env_consistency_check)
+    __kmp_acquire_rw_lock_shared_with_checks(lck, gtid);
+  else
+    __kmp_acquire_rw_lock_shared(lck, gtid);
+#if USE_ITT_BUILD
+  __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  if (ompt_enabled.ompt_callback_mutex_acquired) {
+    ompt_callbacks.ompt_callback(ompt_callback_mutex_acquired)(
+        ompt_mutex_lock, (ompt_wait_id_t)(uintptr_t)user_lock, codeptr);
+  }
+#endif
+#else
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_set_lock(NULL, gtid, user_lock);
+#endif // KMP_USE_DYNAMIC_LOCK
+}
+
+void kmpc_unset_rd_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  kmp_rw_lock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmpc_unset_rd_lock");
+#if USE_ITT_BUILD
+  __kmp_itt_lock_releasing((kmp_user_lock_p)user_lock);
+#endif
+  if (__kmp_env_consistency_check)
+    __kmp_release_rw_lock_shared_with_checks(lck, gtid);
+  else
+    __kmp_release_rw_lock_shared(lck, gtid);
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  if (ompt_enabled.ompt_callback_mutex_released) {
+    ompt_callbacks.ompt_callback(ompt_callback_mutex_released)(
+        ompt_mutex_lock, (ompt_wait_id_t)(uintptr_t)user_lock,
+        OMPT_GET_RETURN_ADDRESS(0));
+  }
+#endif
+#else
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  __kmpc_unset_lock(NULL, gtid, user_lock);
+#endif // KMP_USE_DYNAMIC_LOCK
+}
+
+int kmpc_test_rd_lock(omp_lock_t *lock) {
+  void **user_lock = (void **)lock;
+  int gtid = __kmp_entry_gtid();
+#if KMP_USE_DYNAMIC_LOCK
+  int rc;
+  kmp_rw_lock_t *lck = __kmp_lookup_rw_lock(user_lock, "kmpc_test_rd_lock");
+#if USE_ITT_BUILD
+  __kmp_itt_lock_acquiring((kmp_user_lock_p)user_lock);
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  void *codeptr = OMPT_GET_RETURN_ADDRESS(0);
+  if (ompt_enabled.ompt_callback_mutex_acquire) {
+    ompt_callbacks.ompt_callback(ompt_callback_mutex_acquire)(
+        ompt_mutex_lock, omp_lock_hint_none,
+        __ompt_get_mutex_impl_type(user_lock),
+        (ompt_wait_id_t)(uintptr_t)user_lock, codeptr);
+  }
+#endif
+  if (__kmp_env_consistency_check)
+    rc = __kmp_test_rw_lock_shared_with_checks(lck, gtid);
+  else
+    rc = __kmp_test_rw_lock_shared(lck, gtid);
+  if (rc) {
+#if USE_ITT_BUILD
+    __kmp_itt_lock_acquired((kmp_user_lock_p)user_lock);
+#endif
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+    if (ompt_enabled.ompt_callback_mutex_acquired) {
+      ompt_callbacks.ompt_callback(ompt_callback_mutex_acquired)(
+          ompt_mutex_lock, (ompt_wait_id_t)(uintptr_t)user_lock, codeptr);
+    }
+#endif
+    return TRUE;
+  }
+#if USE_ITT_BUILD
+  __kmp_itt_lock_cancelled((kmp_user_lock_p)user_lock);
+#endif
+  return FALSE;
+#else
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  OMPT_STORE_RETURN_ADDRESS(gtid);
+#endif
+  return __kmpc_test_lock(NULL, gtid, user_lock);
+#endif // KMP_USE_DYNAMIC_LOCK
+}
+
 // Interface to fast scalable reduce methods routines
 
 // keep the selected method in a thread local structure for cross-function
@@ -3373,6 +3669,21 @@ __kmp_swap_teams_for_teams_reduction(kmp_info_t *th, kmp_team_t **team_p,
   return 0;
 }
 
+// Returns true if the barrier terminating a blocking reduction is fused with
+// the barrier the compiler emits after __kmpc_end_reduce(); see
+// KMP_FUSED_REDUCTION_BARRIER.  Reductions at the teams construct keep their
+// own barrier.
+static __forceinline bool
+__kmp_reduce_barrier_fused(PACKED_REDUCTION_METHOD_T packed_reduction_method,
+                           int teams_swapped) {
+  if (!__kmp_fused_reduction_barrier || teams_swapped)
+    return false;
+  if (TEST_REDUCTION_METHOD(packed_reduction_method, tree_reduce_block))
+    return __kmp_barrier_gather_pattern[UNPACK_REDUCTION_BARRIER(
+               packed_reduction_method)] != bp_hierarchical_bar;
+  return true;
+}
+
 static __forceinline void
 __kmp_restore_swapped_teams(kmp_info_t *th, kmp_team_t *team, int task_state) {
   // Restore thread structure swapped in __kmp_swap_teams_for_teams_reduction.
@@ -3698,9 +4009,17 @@ kmp_int32 __kmpc_reduce(ident_t *loc, kmp_int32 global_tid, kmp_int32 num_vars,
     __kmp_threads[global_tid]->th.th_ident =
         loc; // needed for correct notification of frames
 #endif
-    retval =
-        __kmp_barrier(UNPACK_REDUCTION_BARRIER(packed_reduction_method),
-                      global_tid, TRUE, reduce_size, reduce_data, reduce_func);
+    if (__kmp_reduce_barrier_fused(packed_reduction_method, teams_swapped)) {
+      // Only combine up the tree; the barrier following __kmpc_end_reduce()
+      // releases the team once the master has stored the result.
+      retval = __kmp_barrier_gather_reduce(
+          UNPACK_REDUCTION_BARRIER(packed_reduction_method), global_tid,
+          reduce_size, reduce_data, reduce_func);
+    } else {
+      retval = __kmp_barrier(UNPACK_REDUCTION_BARRIER(packed_reduction_method),
+                             global_tid, TRUE, reduce_size, reduce_data,
+                             reduce_func);
+    }
     retval = (retval != 0) ? (0) : (1);
 #if OMPT_SUPPORT && OMPT_OPTIONAL
     if (ompt_enabled.enabled && !set_task_frame) {
@@ -3763,7 +4082,14 @@ void __kmpc_end_reduce(ident_t *loc, kmp_int32 global_tid,
   // this barrier should be visible to a customer and to the threading profile
   // tool (it's a terminating barrier on constructs if NOWAIT not specified)
 
-  if (packed_reduction_method == critical_reduce_block) {
+  if (__kmp_reduce_barrier_fused(packed_reduction_method, teams_swapped)) {
+
+    // the barrier emitted after this call terminates the construct; for the
+    // tree method the workers are not waiting for a release either
+    if (packed_reduction_method == critical_reduce_block)
+      __kmp_end_critical_section_reduce_block(loc, global_tid, lck);
+
+  } else if (packed_reduction_method == critical_reduce_block) {
     __kmp_end_critical_section_reduce_block(loc, global_tid, lck);
 
 // TODO: implicit barrier: should be exposed
@@ -3899,6 +4225,82 @@ kmp_uint64 __kmpc_get_parent_taskid() {
 
 } // __kmpc_get_parent_taskid
 
+// Layout of th_doacross_info: the header is followed by four entries per
+// dimension.
+#define KMP_DOACROSS_INFO_DIMS 4
+#define KMP_DOACROSS_INFO_LN 0 // range of the dimension (unused for dims[0])
+#define KMP_DOACROSS_INFO_LO 1 // lower bound
+#define KMP_DOACROSS_INFO_SPAN 2 // |up - lo|
+#define KMP_DOACROSS_INFO_ST 3 // increment
+
+// Iteration flags are kept in blocks of 32 iterations. If KMP_DOACROSS_WINDOW
+// is set, loop nests larger than it use a window of that many iterations
+// instead of a flag per iteration: block b lives in slot b % W (W slots) and
+// is tagged with its generation b / W + 1. A block takes over its slot once
+// every iteration of the previous generation has been posted, so a waiter
+// that finds a newer generation in the slot knows its iteration is done. This
+// requires every iteration to post: a single missing post stalls all later
+// generations of its slot, which is why the window is off by default.
+typedef struct kmp_doacross_slot {
+  kmp_uint32 mask; // posted iterations of the block
+  kmp_uint32 gen; // generation of the block, 0 if none yet
+} kmp_doacross_slot_t;
+
+#define KMP_DOACROSS_BLOCK_DONE 0xFFFFFFFFu
+#define KMP_DOACROSS_SPINS 4096 // polls before a waiter goes to sleep
+
+// Linearize the iteration vector vec of the loop nest described by info.
+// Returns false if vec is out of the loop bounds. The bounds of all
+// dimensions are checked together, without early exits.
+static inline bool __kmp_doacross_linearize(const kmp_int64 *info,
+                                            const kmp_int64 *vec,
+                                            kmp_uint64 *iter_number) {
+  kmp_int32 num_dims = (kmp_int32)info[0];
+  const kmp_int64 *dim = info + KMP_DOACROSS_INFO_DIMS;
+  kmp_uint64 iter = 0;
+  kmp_uint64 out_of_bounds = 0;
+  for (kmp_int32 i = 0; i < num_dims; ++i, dim += 4) {
+    kmp_int64 st = dim[KMP_DOACROSS_INFO_ST];
+    // distance from the lower bound in the direction of the loop
+    kmp_uint64 d = st > 0 ? (kmp_uint64)(vec[i] - dim[KMP_DOACROSS_INFO_LO])
+                          : (kmp_uint64)(dim[KMP_DOACROSS_INFO_LO] - vec[i]);
+    kmp_uint64 ast = st > 0 ? (kmp_uint64)st : (kmp_uint64)-st;
+    out_of_bounds |= d > (kmp_uint64)dim[KMP_DOACROSS_INFO_SPAN];
+    iter = iter * (kmp_uint64)dim[KMP_DOACROSS_INFO_LN] +
+           (ast == 1 ? d : d / ast);
+  }
+  *iter_number = iter;
+  return !out_of_bounds;
+}
+
+// Sleep until *word changes from val: spin first, then block on a futex where
+// available. *sleepers tells posting threads that a wakeup is needed.
+static void __kmp_doacross_sleep(volatile kmp_uint32 *word, kmp_uint32 val,
+                                 volatile kmp_int32 *sleepers,
+                                 kmp_uint32 *spins) {
+  if (*spins < KMP_DOACROSS_SPINS) {
+    ++*spins;
+    KMP_YIELD(TRUE);
+    return;
+  }
+#if KMP_USE_FUTEX
+  KMP_TEST_THEN_INC32(sleepers);
+  if (*word == val)
+    syscall(__NR_futex, word, FUTEX_WAIT, val, NULL, NULL, 0);
+  KMP_TEST_THEN_DEC32(sleepers);
+#else
+  KMP_YIELD(TRUE);
+#endif
+}
+
+static inline void __kmp_doacross_wake(volatile kmp_uint32 *word,
+                                       volatile kmp_int32 *sleepers) {
+#if KMP_USE_FUTEX
+  if (*sleepers)
+    syscall(__NR_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
 /*!
 @ingroup WORK_SHARING
 @param loc  source location information.
@@ -3913,7 +4315,7 @@ e.g. for(i=2;i<9;i+=2) lo=2, up=8, st=2.
 void __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims,
                           const struct kmp_dim *dims) {
   int j, idx;
-  kmp_int64 last, trace_count;
+  kmp_int64 last, trace_count, window;
   kmp_info_t *th = __kmp_threads[gtid];
   kmp_team_t *team = th->th.th_team;
   kmp_uint32 *flags;
@@ -3939,54 +4341,51 @@ void __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims,
   // Save bounds info into allocated private buffer
   KMP_DEBUG_ASSERT(pr_buf->th_doacross_info == NULL);
   pr_buf->th_doacross_info = (kmp_int64 *)__kmp_thread_malloc(
-      th, sizeof(kmp_int64) * (4 * num_dims + 1));
+      th, sizeof(kmp_int64) * (4 * num_dims + KMP_DOACROSS_INFO_DIMS));
   KMP_DEBUG_ASSERT(pr_buf->th_doacross_info != NULL);
   pr_buf->th_doacross_info[0] =
       (kmp_int64)num_dims; // first element is number of dimensions
   // Save also address of num_done in order to access it later without knowing
   // the buffer index
   pr_buf->th_doacross_info[1] = (kmp_int64)&sh_buf->doacross_num_done;
-  pr_buf->th_doacross_info[2] = dims[0].lo;
-  pr_buf->th_doacross_info[3] = dims[0].up;
-  pr_buf->th_doacross_info[4] = dims[0].st;
-  last = 5;
-  for (j = 1; j < num_dims; ++j) {
-    kmp_int64
-        range_length; // To keep ranges of all dimensions but the first dims[0]
+  pr_buf->th_doacross_info[2] = (kmp_int64)&sh_buf->doacross_sleepers;
+  last = KMP_DOACROSS_INFO_DIMS;
+  trace_count = 1;
+  for (j = 0; j < num_dims; ++j) {
+    kmp_int64 range_length; // To keep ranges of all dimensions
+    kmp_int64 span;
     if (dims[j].st == 1) { // most common case
       // AC: should we care of ranges bigger than LLONG_MAX? (not for now)
-      range_length = dims[j].up - dims[j].lo + 1;
+      span = dims[j].up - dims[j].lo;
+      range_length = span + 1;
     } else {
       if (dims[j].st > 0) {
         KMP_DEBUG_ASSERT(dims[j].up > dims[j].lo);
-        range_length = (kmp_uint64)(dims[j].up - dims[j].lo) / dims[j].st + 1;
+        span = dims[j].up - dims[j].lo;
+        range_length = (kmp_uint64)span / dims[j].st + 1;
       } else { // negative increment
         KMP_DEBUG_ASSERT(dims[j].lo > dims[j].up);
-        range_length =
-            (kmp_uint64)(dims[j].lo - dims[j].up) / (-dims[j].st) + 1;
+        span = dims[j].lo - dims[j].up;
+        range_length = (kmp_uint64)span / (-dims[j].st) + 1;
       }
     }
     pr_buf->th_doacross_info[last++] = range_length;
     pr_buf->th_doacross_info[last++] = dims[j].lo;
-    pr_buf->th_doacross_info[last++] = dims[j].up;
+    pr_buf->th_doacross_info[last++] = span;
     pr_buf->th_doacross_info[last++] = dims[j].st;
+    trace_count *= range_length; // total trip count
   }
+  KMP_DEBUG_ASSERT(trace_count > 0);
 
-  // Compute total trip count.
-  // Start with range of dims[0] which we don't need to keep in the buffer.
-  if (dims[0].st == 1) { // most common case
-    trace_count = dims[0].up - dims[0].lo + 1;
-  } else if (dims[0].st > 0) {
-    KMP_DEBUG_ASSERT(dims[0].up > dims[0].lo);
-    trace_count = (kmp_uint64)(dims[0].up - dims[0].lo) / dims[0].st + 1;
-  } else { // negative increment
-    KMP_DEBUG_ASSERT(dims[0].lo > dims[0].up);
-    trace_count = (kmp_uint64)(dims[0].lo - dims[0].up) / (-dims[0].st) + 1;
-  }
-  for (j = 1; j < num_dims; ++j) {
-    trace_count *= pr_buf->th_doacross_info[4 * j + 1]; // use kept ranges
+  // Use a window of flags for loop nests larger than KMP_DOACROSS_WINDOW if
+  // it is set; the number of slots is a power of two.
+  window = 0;
+  if (__kmp_doacross_window > 0 && trace_count > __kmp_doacross_window) {
+    window = 1;
+    while (window * 32 < __kmp_doacross_window)
+      window <<= 1;
   }
-  KMP_DEBUG_ASSERT(trace_count > 0);
+  pr_buf->th_doacross_info[3] = window;
 
   // Check if shared buffer is not occupied by other loop (idx -
   // __kmp_dispatch_num_buffers)
@@ -4007,7 +4406,11 @@ void __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims,
 #endif
   if (flags == NULL) {
     // we are the first thread, allocate the array of flags
-    size_t size = trace_count / 8 + 8; // in bytes, use single bit per iteration
+    size_t size;
+    if (window)
+      size = window * sizeof(kmp_doacross_slot_t);
+    else
+      size = trace_count / 8 + 8; // in bytes, use single bit per iteration
     flags = (kmp_uint32 *)__kmp_thread_calloc(th, size, 1);
     KMP_MB();
     sh_buf->doacross_flags = flags;
@@ -4027,17 +4430,19 @@ void __kmpc_doacross_init(ident_t *loc, int gtid, int num_dims,
   pr_buf->th_doacross_flags =
       sh_buf->doacross_flags; // save private copy in order to not
   // touch shared buffer on each iteration
-  KA_TRACE(20, ("__kmpc_doacross_init() exit: T#%d\n", gtid));
+  KA_TRACE(20, ("__kmpc_doacross_init() exit: T#%d window %lld\n", gtid,
+                window));
 }
 
 void __kmpc_doacross_wait(ident_t *loc, int gtid, const kmp_int64 *vec) {
-  kmp_int32 shft, num_dims, i;
-  kmp_uint32 flag;
-  kmp_int64 iter_number; // iteration number of "collapsed" loop nest
+  kmp_int32 shft;
+  kmp_uint32 flag, spins = 0;
+  kmp_uint64 iter_number; // iteration number of "collapsed" loop nest
+  kmp_int64 window;
   kmp_info_t *th = __kmp_threads[gtid];
   kmp_team_t *team = th->th.th_team;
   kmp_disp_t *pr_buf;
-  kmp_int64 lo, up, st;
+  volatile kmp_int32 *sleepers;
 
   KA_TRACE(20, ("__kmpc_doacross_wait() enter: called T#%d\n", gtid));
   if (team->t.t_serialized) {
@@ -4048,89 +4453,52 @@ void __kmpc_doacross_wait(ident_t *loc, int gtid, const kmp_int64 *vec) {
   // calculate sequential iteration number and check out-of-bounds condition
   pr_buf = th->th.th_dispatch;
   KMP_DEBUG_ASSERT(pr_buf->th_doacross_info != NULL);
-  num_dims = pr_buf->th_doacross_info[0];
-  lo = pr_buf->th_doacross_info[2];
-  up = pr_buf->th_doacross_info[3];
-  st = pr_buf->th_doacross_info[4];
-  if (st == 1) { // most common case
-    if (vec[0] < lo || vec[0] > up) {
-      KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                    "bounds [%lld,%lld]\n",
-                    gtid, vec[0], lo, up));
-      return;
-    }
-    iter_number = vec[0] - lo;
-  } else if (st > 0) {
-    if (vec[0] < lo || vec[0] > up) {
-      KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                    "bounds [%lld,%lld]\n",
-                    gtid, vec[0], lo, up));
-      return;
-    }
-    iter_number = (kmp_uint64)(vec[0] - lo) / st;
-  } else { // negative increment
-    if (vec[0] > lo || vec[0] < up) {
-      KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                    "bounds [%lld,%lld]\n",
-                    gtid, vec[0], lo, up));
-      return;
-    }
-    iter_number = (kmp_uint64)(lo - vec[0]) / (-st);
-  }
-  for (i = 1; i < num_dims; ++i) {
-    kmp_int64 iter, ln;
-    kmp_int32 j = i * 4;
-    ln = pr_buf->th_doacross_info[j + 1];
-    lo = pr_buf->th_doacross_info[j + 2];
-    up = pr_buf->th_doacross_info[j + 3];
-    st = pr_buf->th_doacross_info[j + 4];
-    if (st == 1) {
-      if (vec[i] < lo || vec[i] > up) {
-        KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                      "bounds [%lld,%lld]\n",
-                      gtid, vec[i], lo, up));
-        return;
-      }
-      iter = vec[i] - lo;
-    } else if (st > 0) {
-      if (vec[i] < lo || vec[i] > up) {
-        KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                      "bounds [%lld,%lld]\n",
-                      gtid, vec[i], lo, up));
-        return;
-      }
-      iter = (kmp_uint64)(vec[i] - lo) / st;
-    } else { // st < 0
-      if (vec[i] > lo || vec[i] < up) {
-        KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter %lld is out of "
-                      "bounds [%lld,%lld]\n",
-                      gtid, vec[i], lo, up));
-        return;
-      }
-      iter = (kmp_uint64)(lo - vec[i]) / (-st);
-    }
-    iter_number = iter + ln * iter_number;
+  if (!__kmp_doacross_linearize(pr_buf->th_doacross_info, vec,
+                                &iter_number)) {
+    KA_TRACE(20, ("__kmpc_doacross_wait() exit: T#%d iter is out of bounds\n",
+                  gtid));
+    return;
   }
+  sleepers = (volatile kmp_int32 *)pr_buf->th_doacross_info[2];
+  window = pr_buf->th_doacross_info[3];
   shft = iter_number % 32; // use 32-bit granularity
-  iter_number >>= 5; // divided by 32
   flag = 1 << shft;
-  while ((flag & pr_buf->th_doacross_flags[iter_number]) == 0) {
-    KMP_YIELD(TRUE);
+  if (window == 0) {
+    volatile kmp_uint32 *word = &pr_buf->th_doacross_flags[iter_number >> 5];
+    kmp_uint32 val;
+    while (((val = *word) & flag) == 0)
+      __kmp_doacross_sleep(word, val, sleepers, &spins);
+  } else {
+    kmp_uint64 block = iter_number >> 5;
+    kmp_uint32 gen = (kmp_uint32)(block / window) + 1;
+    volatile kmp_doacross_slot_t *slot =
+        (volatile kmp_doacross_slot_t *)pr_buf->th_doacross_flags +
+        (block & (window - 1));
+    for (;;) {
+      // read the generation first: a newer generation means the block is done
+      kmp_uint32 g = slot->gen;
+      kmp_uint32 val = slot->mask;
+      if (g > gen || (g == gen && (val & flag)))
+        break;
+      __kmp_doacross_sleep(&slot->mask, val, sleepers, &spins);
+    }
   }
   KMP_MB();
   KA_TRACE(20,
            ("__kmpc_doacross_wait() exit: T#%d wait for iter %lld completed\n",
-            gtid, (iter_number << 5) + shft));
+            gtid, iter_number));
 }
 
 void __kmpc_doacross_post(ident_t *loc, int gtid, const kmp_int64 *vec) {
-  kmp_int32 shft, num_dims, i;
-  kmp_uint32 flag;
-  kmp_int64 iter_number; // iteration number of "collapsed" loop nest
+  kmp_int32 shft;
+  kmp_uint32 flag, spins = 0;
+  kmp_uint64 iter_number; // iteration number of "collapsed" loop nest
+  kmp_int64 window;
   kmp_info_t *th = __kmp_threads[gtid];
   kmp_team_t *team = th->th.th_team;
   kmp_disp_t *pr_buf;
-  kmp_int64 lo, st;
+  volatile kmp_int32 *sleepers;
+  volatile kmp_uint32 *word;
 
   KA_TRACE(20, ("__kmpc_doacross_post() enter: called T#%d\n", gtid));
   if (team->t.t_serialized) {
@@ -4138,43 +4506,57 @@ void __kmpc_doacross_post(ident_t *loc, int gtid, const kmp_int64 *vec) {
     return; // no dependencies if team is serialized
   }
 
-  // calculate sequential iteration number (same as in "wait" but no
-  // out-of-bounds checks)
+  // calculate sequential iteration number (same as in "wait", the bounds are
+  // not expected to be violated)
   pr_buf = th->th.th_dispatch;
   KMP_DEBUG_ASSERT(pr_buf->th_doacross_info != NULL);
-  num_dims = pr_buf->th_doacross_info[0];
-  lo = pr_buf->th_doacross_info[2];
-  st = pr_buf->th_doacross_info[4];
-  if (st == 1) { // most common case
-    iter_number = vec[0] - lo;
-  } else if (st > 0) {
-    iter_number = (kmp_uint64)(vec[0] - lo) / st;
-  } else { // negative increment
-    iter_number = (kmp_uint64)(lo - vec[0]) / (-st);
-  }
-  for (i = 1; i < num_dims; ++i) {
-    kmp_int64 iter, ln;
-    kmp_int32 j = i * 4;
-    ln = pr_buf->th_doacross_info[j + 1];
-    lo = pr_buf->th_doacross_info[j + 2];
-    st = pr_buf->th_doacross_info[j + 4];
-    if (st == 1) {
-      iter = vec[i] - lo;
-    } else if (st > 0) {
-      iter = (kmp_uint64)(vec[i] - lo) / st;
-    } else { // st < 0
-      iter = (kmp_uint64)(lo - vec[i]) / (-st);
-    }
-    iter_number = iter + ln * iter_number;
-  }
+  __kmp_doacross_linearize(pr_buf->th_doacross_info, vec, &iter_number);
+  sleepers = (volatile kmp_int32 *)pr_buf->th_doacross_info[2];
+  window = pr_buf->th_doacross_info[3];
   shft = iter_number % 32; // use 32-bit granularity
-  iter_number >>= 5; // divided by 32
   flag = 1 << shft;
   KMP_MB();
-  if ((flag & pr_buf->th_doacross_flags[iter_number]) == 0)
-    KMP_TEST_THEN_OR32(&pr_buf->th_doacross_flags[iter_number], flag);
+  if (window == 0) {
+    word = &pr_buf->th_doacross_flags[iter_number >> 5];
+    if ((flag & *word) == 0)
+      KMP_TEST_THEN_OR32(word, flag);
+  } else {
+    kmp_uint64 block = iter_number >> 5;
+    kmp_uint32 gen = (kmp_uint32)(block / window) + 1;
+    volatile kmp_doacross_slot_t *slot =
+        (volatile kmp_doacross_slot_t *)pr_buf->th_doacross_flags +
+        (block & (window - 1));
+    word = &slot->mask;
+    for (;;) {
+      kmp_uint32 g = slot->gen;
+      kmp_uint32 val = slot->mask;
+      if (g == gen) {
+        // the block cannot be replaced before this iteration is posted
+        if ((flag & val) == 0)
+          KMP_TEST_THEN_OR32(word, flag);
+        break;
+      }
+      KMP_DEBUG_ASSERT(g < gen);
+      if (g == gen - 1 && (g == 0 || val == KMP_DOACROSS_BLOCK_DONE)) {
+        // the previous generation is done, take over the slot
+        kmp_doacross_slot_t old_slot, new_slot;
+        old_slot.mask = val;
+        old_slot.gen = g;
+        new_slot.mask = flag;
+        new_slot.gen = gen;
+        if (KMP_COMPARE_AND_STORE_ACQ64((volatile kmp_int64 *)slot,
+                                        *(kmp_int64 *)&old_slot,
+                                        *(kmp_int64 *)&new_slot))
+          break;
+        continue;
+      }
+      // the previous generation of the block is still running
+      __kmp_doacross_sleep(word, val, sleepers, &spins);
+    }
+  }
+  __kmp_doacross_wake(word, sleepers);
   KA_TRACE(20, ("__kmpc_doacross_post() exit: T#%d iter %lld posted\n", gtid,
-                (iter_number << 5) + shft));
+                iter_number));
 }
 
 void __kmpc_doacross_fini(ident_t *loc, int gtid) {
@@ -4198,6 +4580,7 @@ void __kmpc_doacross_fini(ident_t *loc, int gtid) {
                      (kmp_int64)&sh_buf->doacross_num_done);
     KMP_DEBUG_ASSERT(num_done == sh_buf->doacross_num_done);
     KMP_DEBUG_ASSERT(idx == sh_buf->doacross_buf_idx);
+    KMP_DEBUG_ASSERT(sh_buf->doacross_sleepers == 0);
     __kmp_thread_free(th, CCAST(kmp_uint32 *, sh_buf->doacross_flags));
     sh_buf->doacross_flags = NULL;
     sh_buf->doacross_num_done = 0;
@@ -28,6 +28,7 @@
 #endif
 #include "kmp_lock.h"
 #include "kmp_dispatch.h"
+#include "kmp_wait_release.h"
 #if KMP_USE_HIER_SCHED
 #include "kmp_dispatch_hier.h"
 #endif
@@ -68,6 +69,146 @@ void __kmp_dispatch_dxo_error(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
   }
 }
 
+// Threads waiting for their turn in ordered loops of a team. A waiter links a
+// record on its stack into the bucket of the iteration it waits for and spins
+// on the record; the thread that moves ordered_iteration to that iteration
+// unlinks the record and sets its go flag, which is the last access to it.
+typedef struct KMP_ALIGN_CACHE kmp_ordered_waiter {
+  std::atomic<kmp_uint32> go;
+  volatile void *ordered_iteration; // identifies the loop
+  kmp_uint64 iter; // iteration waited for
+  struct kmp_ordered_waiter *next;
+} kmp_ordered_waiter_t;
+
+typedef struct KMP_ALIGN_CACHE kmp_ordered_bucket {
+  kmp_ordered_waiter_t *volatile head;
+  volatile kmp_int32 lock;
+} kmp_ordered_bucket_t;
+
+#define KMP_ORDERED_BUCKETS 64
+
+static inline kmp_ordered_bucket_t *
+__kmp_ordered_bucket(kmp_ordered_bucket_t *table, kmp_uint64 iter) {
+  return &table[(iter * 0x9E3779B97F4A7C15ULL) >> 58];
+}
+
+static inline void __kmp_ordered_bucket_lock(kmp_ordered_bucket_t *b) {
+  while (b->lock || !KMP_COMPARE_AND_STORE_ACQ32(&b->lock, 0, 1))
+    KMP_CPU_PAUSE();
+}
+
+static inline void __kmp_ordered_bucket_unlock(kmp_ordered_bucket_t *b) {
+  KMP_MB();
+  b->lock = 0;
+}
+
+static inline kmp_uint64 __kmp_ordered_load(volatile void *p, int size) {
+  return size == 4 ? *(volatile kmp_uint32 *)p : *(volatile kmp_uint64 *)p;
+}
+
+// Unlink rec from the bucket unless a releasing thread did it already.
+static bool __kmp_ordered_unlink(kmp_ordered_bucket_t *b,
+                                 kmp_ordered_waiter_t *rec) {
+  kmp_ordered_waiter_t *volatile *prev = &b->head;
+  bool found = false;
+  __kmp_ordered_bucket_lock(b);
+  for (; *prev != NULL; prev = &(*prev)->next) {
+    if (*prev == rec) {
+      *prev = rec->next;
+      found = true;
+      break;
+    }
+  }
+  __kmp_ordered_bucket_unlock(b);
+  return found;
+}
+
+void __kmp_dispatch_ordered_wait(int gtid, volatile void *ordered_iteration,
+                                 int size, kmp_uint64 lower) {
+  kmp_info_t *th = __kmp_threads[gtid];
+  kmp_team_t *team = th->th.th_team;
+  kmp_ordered_bucket_t *table, *b;
+  kmp_ordered_waiter_t rec;
+  kmp_uint32 spins;
+  int thread_finished = FALSE;
+
+  table = (kmp_ordered_bucket_t *)team->t.t_ordered_waiters;
+  if (table == NULL) {
+    table = (kmp_ordered_bucket_t *)__kmp_allocate(
+        sizeof(kmp_ordered_bucket_t) * KMP_ORDERED_BUCKETS);
+    if (!KMP_COMPARE_AND_STORE_PTR(&team->t.t_ordered_waiters, NULL, table)) {
+      __kmp_free(table);
+      table = (kmp_ordered_bucket_t *)team->t.t_ordered_waiters;
+    }
+  }
+  rec.go = 0;
+  rec.ordered_iteration = ordered_iteration;
+  rec.iter = lower;
+  b = __kmp_ordered_bucket(table, lower);
+  __kmp_ordered_bucket_lock(b);
+  rec.next = b->head;
+  b->head = &rec;
+  __kmp_ordered_bucket_unlock(b);
+  KMP_MB();
+  // The turn may have come before the record was visible.
+  if (__kmp_ordered_load(ordered_iteration, size) >= lower &&
+      __kmp_ordered_unlink(b, &rec))
+    return;
+
+  KD_TRACE(1000, ("__kmp_dispatch_ordered_wait: T#%d waits for iteration "
+                  "%llu\n",
+                  gtid, lower));
+  kmp_flag_32 flag(&rec.go, 1U);
+  KMP_INIT_YIELD(spins);
+  while (KMP_ATOMIC_LD_ACQ(&rec.go) == 0) {
+    // Run tasks of the team while waiting for the turn.
+    kmp_task_team_t *task_team = th->th.th_task_team;
+    if (task_team != NULL && TCR_SYNC_4(task_team->tt.tt_active) &&
+        KMP_TASKING_ENABLED(task_team) &&
+        flag.execute_tasks(th, gtid, FALSE,
+                           &thread_finished USE_ITT_BUILD_ARG(NULL),
+                           __kmp_task_stealing_constraint))
+      continue;
+    KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+  }
+}
+
+void __kmp_dispatch_ordered_release(int gtid, volatile void *ordered_iteration,
+                                    kmp_uint64 iter) {
+  kmp_team_t *team = __kmp_threads[gtid]->th.th_team;
+  kmp_ordered_bucket_t *b = __kmp_ordered_bucket(
+      (kmp_ordered_bucket_t *)team->t.t_ordered_waiters, iter);
+  kmp_ordered_waiter_t *volatile *prev;
+  kmp_ordered_waiter_t *rec = NULL;
+
+  KMP_MB();
+  if (b->head == NULL)
+    return;
+  __kmp_ordered_bucket_lock(b);
+  for (prev = &b->head; *prev != NULL; prev = &(*prev)->next) {
+    if ((*prev)->ordered_iteration == ordered_iteration &&
+        (*prev)->iter == iter) {
+      rec = *prev;
+      *prev = rec->next;
+      break;
+    }
+  }
+  __kmp_ordered_bucket_unlock(b);
+  if (rec != NULL) {
+    KD_TRACE(1000, ("__kmp_dispatch_ordered_release: T#%d hands iteration "
+                    "%llu over\n",
+                    gtid, iter));
+    KMP_ATOMIC_ST_REL(&rec->go, 1);
+  }
+}
+
+void __kmp_dispatch_free_ordered(kmp_team_t *team) {
+  if (team->t.t_ordered_waiters != NULL) {
+    __kmp_free(team->t.t_ordered_waiters);
+    team->t.t_ordered_waiters = NULL;
+  }
+}
+
 // Returns either SCHEDULE_MONOTONIC or SCHEDULE_NONMONOTONIC
 static inline int __kmp_get_monotonicity(enum sched_type schedule,
                                          bool use_hier = false) {
@@ -82,6 +223,81 @@ static inline int __kmp_get_monotonicity(enum sched_type schedule,
   return monotonicity;
 }
 
+#if (KMP_STATIC_STEAL_ENABLED)
+// All operations on the (count, ub) pair of chunk numbers of a static_steal
+// loop must be combined atomically. The pair is packed into 8 bytes when the
+// chunk numbers fit in 32 bits (always for 4-byte induction variables) and is
+// updated as a 16-byte pair otherwise (dcas).
+typedef union {
+  struct {
+    kmp_uint32 count;
+    kmp_uint32 ub;
+  } p;
+  kmp_int64 b;
+} kmp_steal_pair32_t;
+
+template <typename T>
+static inline void __kmp_steal_pair_load(dispatch_private_info_template<T> *pr,
+                                         bool dcas, kmp_uint64 *pair) {
+  volatile kmp_int64 *p = (volatile kmp_int64 *)&pr->u.p.count;
+  if (dcas) {
+    // a torn read is harmless: the following 16-byte CAS fails
+    pair[0] = p[0];
+    pair[1] = p[1];
+  } else {
+    kmp_steal_pair32_t v;
+    v.b = *p;
+    pair[0] = v.p.count;
+    pair[1] = v.p.ub;
+  }
+}
+
+template <typename T>
+static inline bool __kmp_steal_pair_cas(dispatch_private_info_template<T> *pr,
+                                        bool dcas, const kmp_uint64 *vold,
+                                        const kmp_uint64 *vnew) {
+  volatile kmp_int64 *p = (volatile kmp_int64 *)&pr->u.p.count;
+#if KMP_HAVE_CMPXCHG16B
+  if (dcas) {
+    kmp_int64 cv[2] = {(kmp_int64)vold[0], (kmp_int64)vold[1]};
+    kmp_int64 sv[2] = {(kmp_int64)vnew[0], (kmp_int64)vnew[1]};
+    return __kmp_compare_and_store128(p, cv, sv);
+  }
+#endif
+  kmp_steal_pair32_t cv, sv;
+  cv.p.count = (kmp_uint32)vold[0];
+  cv.p.ub = (kmp_uint32)vold[1];
+  sv.p.count = (kmp_uint32)vnew[0];
+  sv.p.ub = (kmp_uint32)vnew[1];
+  // TODO: Should this be acquire or release?
+  return KMP_COMPARE_AND_STORE_ACQ64(p, cv.b, sv.b);
+}
+
+// Replace the owner's own pair after a successful steal. Its chunks are
+// exhausted at that point, so thieves only read it, but the update must not
+// be observed half done.
+template <typename T>
+static inline void
+__kmp_steal_pair_store(dispatch_private_info_template<T> *pr, bool dcas,
+                       const kmp_uint64 *vnew) {
+  if (dcas) {
+    kmp_uint64 vold[2];
+    do {
+      __kmp_steal_pair_load(pr, dcas, vold);
+    } while (!__kmp_steal_pair_cas(pr, dcas, vold, vnew));
+  } else {
+    kmp_steal_pair32_t v;
+    v.p.count = (kmp_uint32)vnew[0];
+    v.p.ub = (kmp_uint32)vnew[1];
+#if KMP_ARCH_X86
+    KMP_XCHG_FIXED64((volatile kmp_int64 *)(&pr->u.p.count), v.b);
+#else
+    *(volatile kmp_int64 *)(&pr->u.p.count) = v.b;
+#endif
+  }
+}
+#endif // ( KMP_STATIC_STEAL_ENABLED )
+
 // Initialize a dispatch_private_info_template<T> buffer for a particular
 // type of schedule,chunk.  The loop description is found in lb (lower bound),
 // ub (upper bound), and st (stride).  nproc is the number of threads relevant
@@ -366,11 +582,27 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
       pr->u.p.parm3 = KMP_MIN(small_chunk + extras, nproc);
       pr->u.p.parm4 = (id + 1) % nproc; // remember neighbour tid
       pr->u.p.st = st;
-      if (traits_t<T>::type_size > 4) {
-        // AC: TODO: check if 16-byte CAS available and use it to
-        // improve performance (probably wait for explicit request
-        // before spending time on this).
-        // For now use dynamically allocated per-thread lock,
+      // Pack the (count, ub) pair into 8 bytes when the chunk numbers fit in
+      // 32 bits, else update it with 16-byte CAS where the CPU has it. All
+      // threads of the team make the same choice as it depends on ntc and
+      // KMP_STEAL_PAIR only; KMP_STEAL_PAIR=dcas or lock turn the packing off
+      // for 8-byte loops, lock also the 16-byte CAS.
+      pr->flags.steal_packed =
+          (traits_t<T>::type_size == 4 ||
+           (__kmp_steal_pair == 0 && (UT)ntc < (UT)KMP_INT_MAX));
+#if KMP_HAVE_CMPXCHG16B
+      pr->flags.steal_dcas = (!pr->flags.steal_packed && __kmp_steal_pair < 2 &&
+                              __kmp_cpuinfo.cmpxchg16b);
+#else
+      pr->flags.steal_dcas = FALSE;
+#endif
+      if (traits_t<T>::type_size > 4 && pr->flags.steal_packed) {
+        kmp_steal_pair32_t v;
+        v.p.count = (kmp_uint32)pr->u.p.count;
+        v.p.ub = (kmp_uint32)pr->u.p.ub;
+        *(volatile kmp_int64 *)(&pr->u.p.count) = v.b;
+      } else if (traits_t<T>::type_size > 4 && !pr->flags.steal_dcas) {
+        // Use dynamically allocated per-thread lock,
         // free memory in __kmp_dispatch_next when status==0.
         KMP_DEBUG_ASSERT(th->th.th_dispatch->th_steal_lock == NULL);
         th->th.th_dispatch->th_steal_lock =
@@ -636,6 +868,12 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
     if (pr->u.p.parm1 <= 0) {
       pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
     }
+    // dynamic: parm4 is the largest number of chunks grabbed at once, parm2
+    // and parm3 delimit the chunk numbers grabbed but not yet served. Ordered
+    // loops must hand out chunks in order, so they are never batched.
+    pr->u.p.parm2 = pr->u.p.parm3 = 0;
+    pr->u.p.parm4 =
+        (pr->flags.ordered || use_hier) ? 1 : __kmp_dispatch_chunk_batch;
     KD_TRACE(100, ("__kmp_dispatch_init_algorithm: T#%d "
                    "kmp_sch_static_chunked/kmp_sch_dynamic_chunked cases\n",
                    gtid));
@@ -736,6 +974,49 @@ __kmp_dispatch_init_hier_runtime<kmp_uint64>(ident_t *loc, kmp_uint64 lb,
       __kmp_hier_scheds.scheds, __kmp_hier_scheds.large_chunks, lb, ub, st);
 }
 
+// Hierarchy used for the dynamic runtime loops of large teams when
+// OMP_SCHEDULE does not give one: the NUMA domains take guided chunks of the
+// loop and the threads of a domain share each chunk through the domain's own
+// buffer, so most chunk grabs stay on a domain-local cache line.
+template <typename T>
+static void __kmp_dispatch_init_hier_auto(ident_t *loc, T lb, T ub,
+                                          typename traits_t<T>::signed_t st) {
+  kmp_hier_layer_e layer = kmp_hier_layer_e::LAYER_NUMA;
+  enum sched_type sched = kmp_sch_guided_iterative_chunked;
+  typename traits_t<T>::signed_t chunk = 1;
+  __kmp_dispatch_init_hierarchy<T>(loc, 1, &layer, &sched, &chunk, lb, ub, st);
+}
+
+// Whether a loop of the team should use the automatic hierarchy. The answer
+// must be the same for all threads of the team. Only schedule(runtime) and
+// schedule(auto) loops qualify: a schedule written in the source is kept as
+// is. A single NUMA domain gains nothing from the hierarchy, unless
+// KMP_DISP_HIER_AUTO was set explicitly.
+static bool __kmp_dispatch_use_hier_auto(enum sched_type schedule,
+                                         kmp_team_t *team) {
+  if (__kmp_dispatch_hier_auto <= 0 || team->t.t_serialized ||
+      team->t.t_nproc < __kmp_dispatch_hier_auto ||
+      (!__kmp_env_disp_hier_auto &&
+       __kmp_hier_max_units[kmp_hier_layer_e::LAYER_NUMA + 1] < 2))
+    return false;
+  schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+  if (schedule == kmp_sch_auto) // unless tuned per call site
+    return !__kmp_adaptive_auto;
+  if (schedule != kmp_sch_runtime)
+    return false;
+  switch (SCHEDULE_WITHOUT_MODIFIERS(team->t.t_sched.r_sched_type)) {
+  case kmp_sch_dynamic_chunked:
+  case kmp_sch_guided_chunked:
+  case kmp_sch_guided_iterative_chunked:
+  case kmp_sch_guided_analytical_chunked:
+    return true;
+  case kmp_sch_auto:
+    return !__kmp_adaptive_auto;
+  default:
+    return false;
+  }
+}
+
 // free all the hierarchy scheduling memory associated with the team
 void __kmp_dispatch_free_hierarchies(kmp_team_t *team) {
   int num_disp_buff = team->t.t_max_nproc > 1 ? __kmp_dispatch_num_buffers : 2;
@@ -752,6 +1033,459 @@ void __kmp_dispatch_free_hierarchies(kmp_team_t *team) {
 }
 #endif
 
+// Adaptive schedule(auto).
+// Every loop site (ident_t) executed with schedule(auto) keeps a record of how
+// well its previous executions were balanced. The first thread of the team
+// that reaches an instance of the loop picks the schedule for the whole team
+// from that record, and the last thread to finish folds the per-thread
+// execution times back into it. A site starts with an even static partition.
+// While the per-thread times show that the cost per iteration is stable, the
+// record keeps a cost density over the normalized iteration space from which a
+// weighted static partition is computed, so non-uniform loops (triangular,
+// sparse rows) converge to a balanced partition without dispatch overhead. If
+// the partition does not converge, the site moves on to static_steal, guided
+// and then dynamic with a shrinking chunk, and is probed again from time to
+// time.
+
+#define KMP_AUTO_SCHED_SITES 256 // number of loop sites tracked
+#define KMP_AUTO_SCHED_PROBES 8 // hash probes before giving up on a site
+#define KMP_AUTO_SCHED_BINS 64 // resolution of the cost density
+#define KMP_AUTO_SCHED_TOLERANCE 0.1 // acceptable imbalance
+#define KMP_AUTO_SCHED_TRIES 4 // weighted runs allowed to converge
+#define KMP_AUTO_SCHED_REPROBE 64 // executions before a dynamic site re-probes
+
+// sh->auto_loop values besides an actual instance
+#define KMP_AUTO_LOOP_BUSY ((void *)1) // a thread is choosing the schedule
+#define KMP_AUTO_LOOP_NONE ((void *)2) // the loop runs with __kmp_auto
+
+enum kmp_auto_sched_state {
+  auto_sched_probe = 0, // even static partition, measure costs
+  auto_sched_weighted, // static partition from the cost density
+  auto_sched_steal, // static_steal with a tuned chunk
+  auto_sched_guided, // guided with a tuned chunk
+  auto_sched_dynamic // dynamic with a shrinking chunk
+};
+
+typedef struct kmp_auto_sched_rec {
+  ident_t *volatile loc; // loop site, NULL if the slot is free
+  volatile kmp_int32 lock; // protects the fields below
+  kmp_int32 nproc; // team size the record was tuned for
+  kmp_int32 state; // kmp_auto_sched_state for the next execution
+  kmp_int32 chunk; // chunk for the dynamic states
+  kmp_int32 tries; // unbalanced weighted executions in a row
+  kmp_uint32 execs; // executions in the current state
+  double density[KMP_AUTO_SCHED_BINS]; // relative cost of each bin
+} kmp_auto_sched_rec_t;
+
+// Schedule of one execution of a loop, shared by the team
+typedef struct kmp_auto_loop {
+  kmp_auto_sched_rec_t *rec;
+  kmp_int32 state;
+  kmp_int32 nproc;
+  kmp_int32 chunk;
+  kmp_uint64 tc;
+  kmp_uint64 *part; // nproc + 1 iteration boundaries for the static states
+  kmp_uint64 *start; // per-thread start times
+  kmp_uint64 *time; // per-thread execution times
+} kmp_auto_loop_t;
+
+static kmp_auto_sched_rec_t __kmp_auto_sched_recs[KMP_AUTO_SCHED_SITES];
+
+static void __kmp_auto_sched_acquire(kmp_auto_sched_rec_t *rec) {
+  while (rec->lock || !KMP_COMPARE_AND_STORE_ACQ32(&rec->lock, 0, 1))
+    KMP_CPU_PAUSE();
+}
+
+static void __kmp_auto_sched_release(kmp_auto_sched_rec_t *rec) {
+  KMP_MB();
+  TCW_4(rec->lock, 0);
+}
+
+static void __kmp_auto_sched_reset(kmp_auto_sched_rec_t *rec, int nproc) {
+  int b;
+  rec->nproc = nproc;
+  rec->state = auto_sched_probe;
+  rec->chunk = 0;
+  rec->tries = 0;
+  rec->execs = 0;
+  for (b = 0; b < KMP_AUTO_SCHED_BINS; ++b)
+    rec->density[b] = 1.0 / KMP_AUTO_SCHED_BINS;
+}
+
+// Find or claim the record of a loop site; NULL if the table is full around it
+static kmp_auto_sched_rec_t *__kmp_auto_sched_find(ident_t *loc) {
+  kmp_uintptr_t h = (kmp_uintptr_t)loc;
+  int i;
+
+  h = (h >> 3) ^ (h >> 11);
+  for (i = 0; i < KMP_AUTO_SCHED_PROBES; ++i) {
+    kmp_auto_sched_rec_t *rec =
+        &__kmp_auto_sched_recs[(h + i) % KMP_AUTO_SCHED_SITES];
+    ident_t *key = (ident_t *)TCR_PTR(rec->loc);
+    if (key == loc)
+      return rec;
+    if (key == NULL && KMP_COMPARE_AND_STORE_PTR(&rec->loc, NULL, loc))
+      return rec; // nproc == 0 makes the first user reset it
+    if (TCR_PTR(rec->loc) == loc)
+      return rec; // claimed concurrently for the same site
+  }
+  return NULL;
+}
+
+// Boundaries that give every thread the same share of the cost density
+static void __kmp_auto_sched_partition(const double *density, int nproc,
+                                       kmp_uint64 tc, kmp_uint64 *part) {
+  double total = 0, target, acc = 0;
+  int b = 0, t;
+
+  for (t = 0; t < KMP_AUTO_SCHED_BINS; ++t)
+    total += density[t];
+  part[0] = 0;
+  for (t = 1; t < nproc; ++t) {
+    double x;
+    kmp_uint64 bound;
+    target = total * t / nproc;
+    while (b < KMP_AUTO_SCHED_BINS - 1 && acc + density[b] < target)
+      acc += density[b++];
+    // the cost is taken as uniform within a bin
+    x = density[b] > 0 ? (target - acc) / density[b] : 0;
+    x = (b + KMP_MIN(KMP_MAX(x, 0.0), 1.0)) / KMP_AUTO_SCHED_BINS;
+    bound = (kmp_uint64)(x * tc + 0.5);
+    part[t] = KMP_MIN(KMP_MAX(bound, part[t - 1]), tc);
+  }
+  part[nproc] = tc;
+}
+
+// Rescale the density within each thread's block to the time it took
+static void __kmp_auto_sched_update_density(kmp_auto_sched_rec_t *rec,
+                                            kmp_auto_loop_t *inst) {
+  double fresh[KMP_AUTO_SCHED_BINS];
+  double total = 0;
+  int b, t;
+
+  for (b = 0; b < KMP_AUTO_SCHED_BINS; ++b)
+    fresh[b] = 0;
+  for (t = 0; t < inst->nproc; ++t) {
+    double x0 = (double)inst->part[t] * KMP_AUTO_SCHED_BINS / inst->tc;
+    double x1 = (double)inst->part[t + 1] * KMP_AUTO_SCHED_BINS / inst->tc;
+    double mass = 0, scale;
+    int first = (int)x0, last = KMP_MIN((int)x1, KMP_AUTO_SCHED_BINS - 1);
+    if (x1 <= x0)
+      continue;
+    for (b = first; b <= last; ++b)
+      mass += rec->density[b] * (KMP_MIN(x1, b + 1.0) - KMP_MAX(x0, (double)b));
+    scale = mass > 0 ? inst->time[t] / mass : 0;
+    for (b = first; b <= last; ++b)
+      fresh[b] += rec->density[b] * scale *
+                  (KMP_MIN(x1, b + 1.0) - KMP_MAX(x0, (double)b));
+  }
+  for (b = 0; b < KMP_AUTO_SCHED_BINS; ++b)
+    total += fresh[b];
+  if (total <= 0)
+    return; // nothing measurable
+  for (b = 0; b < KMP_AUTO_SCHED_BINS; ++b)
+    rec->density[b] = fresh[b] / total;
+}
+
+// Called by the last thread of the team to finish an execution of the loop
+static void __kmp_auto_sched_end(kmp_auto_loop_t *inst, kmp_int32 gtid) {
+  kmp_auto_sched_rec_t *rec = inst->rec;
+  kmp_uint64 max = 0;
+  double sum = 0, imbalance;
+  int t;
+
+  for (t = 0; t < inst->nproc; ++t) {
+    sum += inst->time[t];
+    if (inst->time[t] > max)
+      max = inst->time[t];
+  }
+  imbalance = max ? 1.0 - sum / inst->nproc / max : 0.0;
+
+  __kmp_auto_sched_acquire(rec);
+  if (rec->nproc == inst->nproc) { // else retuned for another team size
+    int balanced = imbalance <= KMP_AUTO_SCHED_TOLERANCE;
+    int state = inst->state;
+    rec->execs++;
+    switch (state) {
+    case auto_sched_probe:
+    case auto_sched_weighted:
+      __kmp_auto_sched_update_density(rec, inst);
+      if (balanced) {
+        rec->tries = 0;
+        state = auto_sched_weighted;
+      } else if (state == auto_sched_weighted &&
+                 ++rec->tries >= KMP_AUTO_SCHED_TRIES) {
+        // a stable cost would have converged by now
+        state = auto_sched_steal;
+        rec->chunk =
+            (kmp_int32)KMP_MAX(inst->tc / ((kmp_uint64)inst->nproc * 16), 1);
+      } else {
+        state = auto_sched_weighted;
+      }
+      break;
+    case auto_sched_steal:
+      if (!balanced)
+        state = auto_sched_guided;
+      break;
+    case auto_sched_guided:
+      if (!balanced)
+        state = auto_sched_dynamic;
+      break;
+    case auto_sched_dynamic:
+      if (!balanced && rec->chunk > 1)
+        rec->chunk /= 2;
+      break;
+    }
+    if (state >= auto_sched_steal && rec->execs >= KMP_AUTO_SCHED_REPROBE) {
+      __kmp_auto_sched_reset(rec, inst->nproc); // the cost may have settled
+      state = auto_sched_probe;
+    }
+    if (state != rec->state)
+      rec->execs = 0;
+    rec->state = state;
+    KD_TRACE(50, ("__kmp_auto_sched_end: T#%d loc:%p imbalance:%d%% state "
+                  "%d -> %d chunk:%d\n",
+                  gtid, rec->loc, (int)(imbalance * 100), inst->state, state,
+                  rec->chunk));
+  }
+  __kmp_auto_sched_release(rec);
+}
+
+// Choose the schedule of a schedule(auto) loop for the calling thread. The
+// first thread of the team to get here makes the choice for all of them.
+// Returns the instance, or NULL if the loop runs with the __kmp_auto mapping.
+template <typename T>
+static kmp_auto_loop_t *
+__kmp_auto_sched_begin(ident_t *loc, int gtid,
+                       dispatch_shared_info_template<T> volatile *sh, T lb,
+                       T ub, typename traits_t<T>::signed_t st, int nproc) {
+  typedef typename traits_t<T>::unsigned_t UT;
+  void *p = TCR_PTR(sh->auto_loop);
+
+  if (p == NULL && KMP_COMPARE_AND_STORE_PTR(&sh->auto_loop, NULL,
+                                             KMP_AUTO_LOOP_BUSY)) {
+    kmp_auto_sched_rec_t *rec = NULL;
+    kmp_auto_loop_t *inst;
+    UT tc;
+
+    if (st == 1)
+      tc = ub >= lb ? (UT)(ub - lb) + 1 : 0;
+    else if (st < 0)
+      tc = lb >= ub ? (UT)(lb - ub) / (-st) + 1 : 0;
+    else
+      tc = ub >= lb && st > 0 ? (UT)(ub - lb) / st + 1 : 0;
+    if (loc != NULL && tc >= (UT)nproc * 2)
+      rec = __kmp_auto_sched_find(loc);
+    if (rec == NULL) {
+      TCW_PTR(sh->auto_loop, KMP_AUTO_LOOP_NONE);
+      return NULL;
+    }
+    inst = (kmp_auto_loop_t *)__kmp_fast_allocate(
+        __kmp_threads[gtid],
+        sizeof(kmp_auto_loop_t) + (3 * nproc + 1) * sizeof(kmp_uint64));
+    inst->rec = rec;
+    inst->nproc = nproc;
+    inst->tc = tc;
+    inst->part = (kmp_uint64 *)(inst + 1);
+    inst->start = inst->part + nproc + 1;
+    inst->time = inst->start + nproc;
+    __kmp_auto_sched_acquire(rec);
+    if (rec->nproc != nproc)
+      __kmp_auto_sched_reset(rec, nproc);
+    inst->state = rec->state;
+    inst->chunk = rec->chunk;
+    if (inst->state <= auto_sched_weighted)
+      __kmp_auto_sched_partition(rec->density, nproc, tc, inst->part);
+    __kmp_auto_sched_release(rec);
+    KMP_MB();
+    TCW_PTR(sh->auto_loop, inst);
+    p = inst;
+  } else {
+    while ((p = TCR_PTR(sh->auto_loop)) == KMP_AUTO_LOOP_BUSY)
+      KMP_CPU_PAUSE();
+  }
+  return p == KMP_AUTO_LOOP_NONE ? NULL : (kmp_auto_loop_t *)p;
+}
+
+// Hand the thread its block of a weighted static partition; the buffer was
+// set up for kmp_sch_static_balanced.
+template <typename T>
+static void __kmp_auto_sched_set_block(dispatch_private_info_template<T> *pr,
+                                       kmp_auto_loop_t *inst, T lb, T ub,
+                                       typename traits_t<T>::signed_t st,
+                                       int tid) {
+  kmp_uint64 begin = inst->part[tid], end = inst->part[tid + 1];
+  T init, limit;
+
+  if (begin >= end) {
+    pr->u.p.count = 1; /* means no more chunks to execute */
+    pr->u.p.parm1 = FALSE;
+    return;
+  }
+  init = (T)begin;
+  limit = (T)(end - 1);
+  pr->u.p.count = 0;
+  pr->u.p.parm1 = (end == inst->tc); /* parm1 stores *plastiter */
+  if (st == 1) {
+    pr->u.p.lb = lb + init;
+    pr->u.p.ub = lb + limit;
+  } else {
+    T ub_tmp = lb + limit * st;
+    pr->u.p.lb = lb + init * st;
+    if (st > 0) {
+      pr->u.p.ub = (ub_tmp + st > ub ? ub : ub_tmp);
+    } else {
+      pr->u.p.ub = (ub_tmp + st < ub ? ub : ub_tmp);
+    }
+  }
+}
+
+static inline bool __kmp_dispatch_is_auto(enum sched_type schedule,
+                                          kmp_team_t *team) {
+  schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+  if (schedule == kmp_sch_runtime)
+    schedule = SCHEDULE_WITHOUT_MODIFIERS(team->t.t_sched.r_sched_type);
+  return schedule == kmp_sch_auto;
+}
+
+// Elastic dispatch buffer ring (KMP_DISP_ELASTIC).
+// Loop number idx of a team normally runs in the ring slot idx % N, and a
+// thread that gets N loops ahead of the slowest one has to wait until the
+// slot's previous loop is finished. In the elastic mode the first thread
+// reaching loop idx decides whether the slot is free; when it is not, the loop
+// runs in an overflow buffer taken from the team instead. The decision is
+// kept in the slot's ring_claim word: the low half is the last decided loop
+// and the high half the loop occupying the slot, both + 1. buffer_index still
+// counts the finished loops of the slot, whether they ran in the slot or not.
+// The mode is off by default: the overflow lists of all teams are protected by
+// the one global __kmp_disp_overflow_lock.
+typedef struct kmp_disp_overflow {
+  dispatch_shared_info_t sh; // must be first
+  struct kmp_disp_overflow *next;
+  kmp_uint32 index; // loop number using the buffer
+  int nproc_cap; // number of private buffers
+  dispatch_private_info_t pr[1]; // one per thread of the team
+} kmp_disp_overflow_t;
+
+static KMP_BOOTSTRAP_LOCK_INIT(__kmp_disp_overflow_lock);
+
+// Find or create the overflow buffer of loop idx; protected by
+// __kmp_disp_overflow_lock.
+static kmp_disp_overflow_t *__kmp_dispatch_get_overflow(kmp_team_t *team,
+                                                        kmp_uint32 idx,
+                                                        int nproc) {
+  kmp_disp_overflow_t *rec, **prev;
+  __kmp_acquire_bootstrap_lock(&__kmp_disp_overflow_lock);
+  for (rec = (kmp_disp_overflow_t *)team->t.t_disp_overflow; rec != NULL;
+       rec = rec->next) {
+    if (rec->index == idx)
+      break;
+  }
+  if (rec == NULL) {
+    // Buffers are recycled rather than freed: a thread looking for a victim
+    // of static_steal may still read a private buffer it saw earlier.
+    prev = (kmp_disp_overflow_t **)&team->t.t_disp_overflow_free;
+    while (*prev != NULL && (*prev)->nproc_cap < nproc)
+      prev = &(*prev)->next;
+    rec = *prev;
+    if (rec != NULL) {
+      *prev = rec->next;
+    } else {
+      rec = (kmp_disp_overflow_t *)__kmp_allocate(
+          sizeof(kmp_disp_overflow_t) +
+          (nproc - 1) * sizeof(dispatch_private_info_t));
+      rec->nproc_cap = nproc;
+    }
+    rec->index = idx;
+    rec->next = (kmp_disp_overflow_t *)team->t.t_disp_overflow;
+    team->t.t_disp_overflow = rec;
+    KD_TRACE(100, ("__kmp_dispatch_get_overflow: team %d loop %u moved off "
+                   "the ring\n",
+                   team->t.t_id, idx));
+  }
+  __kmp_release_bootstrap_lock(&__kmp_disp_overflow_lock);
+  return rec;
+}
+
+// Called by the last thread of a loop that ran in an overflow buffer.
+static void __kmp_dispatch_release_overflow(kmp_team_t *team,
+                                            kmp_disp_overflow_t *rec) {
+  kmp_disp_overflow_t **prev;
+  dispatch_shared_info_t *slot =
+      &team->t.t_disp_buffer[rec->index % __kmp_dispatch_num_buffers];
+  KMP_TEST_THEN_ADD32((volatile kmp_int32 *)&slot->buffer_index,
+                      __kmp_dispatch_num_buffers);
+  __kmp_acquire_bootstrap_lock(&__kmp_disp_overflow_lock);
+  prev = (kmp_disp_overflow_t **)&team->t.t_disp_overflow;
+  while (*prev != rec)
+    prev = &(*prev)->next;
+  *prev = rec->next;
+  rec->next = (kmp_disp_overflow_t *)team->t.t_disp_overflow_free;
+  team->t.t_disp_overflow_free = rec;
+  __kmp_release_bootstrap_lock(&__kmp_disp_overflow_lock);
+}
+
+static inline bool __kmp_dispatch_in_ring(kmp_team_t *team,
+                                          volatile void *sh) {
+  dispatch_shared_info_t *ring = team->t.t_disp_buffer;
+  return (volatile void *)ring <= sh &&
+         sh < (volatile void *)(ring + __kmp_dispatch_num_buffers);
+}
+
+void __kmp_dispatch_free_overflow(kmp_team_t *team) {
+  kmp_disp_overflow_t *rec, *next;
+  KMP_DEBUG_ASSERT(team->t.t_disp_overflow == NULL);
+  for (rec = (kmp_disp_overflow_t *)team->t.t_disp_overflow_free; rec != NULL;
+       rec = next) {
+    next = rec->next;
+    __kmp_free(rec);
+  }
+  team->t.t_disp_overflow_free = NULL;
+}
+
+// Pick the buffers of loop idx without waiting for the ring slot.
+template <typename T>
+static void
+__kmp_dispatch_get_buffers(kmp_info_t *th, kmp_team_t *team, kmp_uint32 idx,
+                           dispatch_private_info_template<T> **ppr,
+                           dispatch_shared_info_template<T> volatile **psh) {
+  dispatch_shared_info_t *slot =
+      &team->t.t_disp_buffer[idx % __kmp_dispatch_num_buffers];
+  kmp_uint32 mine = idx + 1;
+  kmp_uint32 occupant;
+  for (;;) {
+    kmp_uint64 claim = slot->ring_claim;
+    // loop idx or a later one is decided; compared modulo 2^32 as the loop
+    // numbers wrap around
+    if ((kmp_int32)((kmp_uint32)claim - mine) >= 0) {
+      occupant = (kmp_uint32)(claim >> 32);
+      break;
+    }
+    occupant = TCR_4(slot->buffer_index) == idx ? mine
+                                                : (kmp_uint32)(claim >> 32);
+    if (KMP_COMPARE_AND_STORE_ACQ64(
+            (volatile kmp_int64 *)&slot->ring_claim, (kmp_int64)claim,
+            (kmp_int64)(((kmp_uint64)occupant << 32) | mine)))
+      break;
+  }
+  KMP_MB();
+  if (occupant == mine) {
+    *ppr = reinterpret_cast<dispatch_private_info_template<T> *>(
+        &th->th.th_dispatch->th_disp_buffer[idx % __kmp_dispatch_num_buffers]);
+    *psh = reinterpret_cast<dispatch_shared_info_template<T> volatile *>(slot);
+  } else {
+    kmp_disp_overflow_t *rec =
+        __kmp_dispatch_get_overflow(team, idx, th->th.th_team_nproc);
+    *ppr = reinterpret_cast<dispatch_private_info_template<T> *>(
+        &rec->pr[th->th.th_info.ds.ds_tid]);
+    *psh = reinterpret_cast<dispatch_shared_info_template<T> volatile *>(
+        &rec->sh);
+    // The buffer may have served other loops of the team: keep static_steal
+    // from matching a victim that is in another loop.
+    (*ppr)->u.p.static_steal_counter = (T)~idx;
+  }
+}
+
 // UT - unsigned flavor of T, ST - signed flavor of T,
 // DBL - double if sizeof(T)==4, or long double if sizeof(T)==8
 template <typename T>
@@ -767,6 +1501,7 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
   kmp_uint32 my_buffer_index;
   dispatch_private_info_template<T> *pr;
   dispatch_shared_info_template<T> volatile *sh;
+  bool buffer_ready = false; // the buffers are free to use
 
   KMP_BUILD_ASSERT(sizeof(dispatch_private_info_template<T>) ==
                    sizeof(dispatch_private_info));
@@ -837,6 +1572,9 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
     // use the runtime hierarchy if one was specified in the program
     if (!ordered && !pr->flags.use_hier)
       __kmp_dispatch_init_hier_runtime<T>(loc, lb, ub, st);
+  } else if (!ordered && !pr->flags.use_hier &&
+             __kmp_dispatch_use_hier_auto(schedule, team)) {
+    __kmp_dispatch_init_hier_auto<T>(loc, lb, ub, st);
   }
 #endif // KMP_USE_HIER_SCHED
 
@@ -860,18 +1598,71 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
     pr = reinterpret_cast<dispatch_private_info_template<T> *>(
         &th->th.th_dispatch
              ->th_disp_buffer[my_buffer_index % __kmp_dispatch_num_buffers]);
-    sh = reinterpret_cast<dispatch_shared_info_template<T> volatile *>(
-        &team->t.t_disp_buffer[my_buffer_index % __kmp_dispatch_num_buffers]);
+    if (__kmp_dispatch_elastic
+#if KMP_USE_HIER_SCHED
+        && !pr->flags.use_hier
+#endif
+    ) {
+      __kmp_dispatch_get_buffers<T>(th, team, my_buffer_index, &pr, &sh);
+      buffer_ready = true;
+    } else {
+      sh = reinterpret_cast<dispatch_shared_info_template<T> volatile *>(
+          &team->t
+               .t_disp_buffer[my_buffer_index % __kmp_dispatch_num_buffers]);
+    }
     KD_TRACE(10, ("__kmp_dispatch_init: T#%d my_buffer_index:%d\n", gtid,
                   my_buffer_index));
   }
 
+  kmp_auto_loop_t *auto_loop = NULL;
+  if (active && __kmp_adaptive_auto && __kmp_dispatch_is_auto(schedule, team)
+#if KMP_USE_HIER_SCHED
+      && !pr->flags.use_hier
+#endif
+  ) {
+    // The whole team must run the loop with the same schedule, so the buffer
+    // has to be free before the first thread picks it.
+    if (!buffer_ready) {
+      __kmp_wait<kmp_uint32>(&sh->buffer_index, my_buffer_index,
+                             __kmp_eq<kmp_uint32> USE_ITT_BUILD_ARG(NULL));
+      KMP_MB();
+    }
+    auto_loop = __kmp_auto_sched_begin<T>(loc, gtid, sh, lb, ub, st,
+                                          th->th.th_team_nproc);
+    if (auto_loop != NULL) {
+      switch (auto_loop->state) {
+      case auto_sched_probe:
+      case auto_sched_weighted:
+        schedule = kmp_sch_static_balanced;
+        break;
+#if KMP_STATIC_STEAL_ENABLED
+      case auto_sched_steal:
+        schedule = kmp_sch_static_steal;
+        break;
+#endif
+      case auto_sched_dynamic:
+        schedule = kmp_sch_dynamic_chunked;
+        break;
+      default:
+        schedule = kmp_sch_guided_iterative_chunked;
+        break;
+      }
+      chunk = auto_loop->chunk;
+    }
+  }
+
   __kmp_dispatch_init_algorithm(loc, gtid, pr, schedule, lb, ub, st,
 #if USE_ITT_BUILD
                                 &cur_chunk,
 #endif
                                 chunk, (T)th->th.th_team_nproc,
                                 (T)th->th.th_info.ds.ds_tid);
+  if (auto_loop != NULL) {
+    int tid = th->th.th_info.ds.ds_tid;
+    if (auto_loop->state <= auto_sched_weighted)
+      __kmp_auto_sched_set_block(pr, auto_loop, lb, ub, st, tid);
+    auto_loop->start[tid] = KMP_NOW();
+  }
   if (active) {
     if (pr->flags.ordered == 0) {
       th->th.th_dispatch->th_deo_fcn = __kmp_dispatch_deo_error;
@@ -886,17 +1677,20 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
     /* The name of this buffer should be my_buffer_index when it's free to use
      * it */
 
-    KD_TRACE(100, ("__kmp_dispatch_init: T#%d before wait: my_buffer_index:%d "
-                   "sh->buffer_index:%d\n",
-                   gtid, my_buffer_index, sh->buffer_index));
-    __kmp_wait<kmp_uint32>(&sh->buffer_index, my_buffer_index,
-                           __kmp_eq<kmp_uint32> USE_ITT_BUILD_ARG(NULL));
-    // Note: KMP_WAIT() cannot be used there: buffer index and
-    // my_buffer_index are *always* 32-bit integers.
-    KMP_MB(); /* is this necessary? */
-    KD_TRACE(100, ("__kmp_dispatch_init: T#%d after wait: my_buffer_index:%d "
-                   "sh->buffer_index:%d\n",
-                   gtid, my_buffer_index, sh->buffer_index));
+    if (!buffer_ready) {
+      KD_TRACE(100,
+               ("__kmp_dispatch_init: T#%d before wait: my_buffer_index:%d "
+                "sh->buffer_index:%d\n",
+                gtid, my_buffer_index, sh->buffer_index));
+      __kmp_wait<kmp_uint32>(&sh->buffer_index, my_buffer_index,
+                             __kmp_eq<kmp_uint32> USE_ITT_BUILD_ARG(NULL));
+      // Note: KMP_WAIT() cannot be used there: buffer index and
+      // my_buffer_index are *always* 32-bit integers.
+      KMP_MB(); /* is this necessary? */
+      KD_TRACE(100, ("__kmp_dispatch_init: T#%d after wait: my_buffer_index:%d "
+                     "sh->buffer_index:%d\n",
+                     gtid, my_buffer_index, sh->buffer_index));
+    }
 
     th->th.th_dispatch->th_dispatch_pr_current = (dispatch_private_info_t *)pr;
     th->th.th_dispatch->th_dispatch_sh_current =
@@ -1036,8 +1830,7 @@ static void __kmp_dispatch_finish(int gtid, ident_t *loc) {
       }
 #endif
 
-      __kmp_wait<UT>(&sh->u.s.ordered_iteration, lower,
-                     __kmp_ge<UT> USE_ITT_BUILD_ARG(NULL));
+      __kmp_dispatch_wait_ordered<UT>(gtid, &sh->u.s.ordered_iteration, lower);
       KMP_MB(); /* is this necessary? */
 #ifdef KMP_DEBUG
       {
@@ -1051,7 +1844,10 @@ static void __kmp_dispatch_finish(int gtid, ident_t *loc) {
       }
 #endif
 
-      test_then_inc<ST>((volatile ST *)&sh->u.s.ordered_iteration);
+      __kmp_dispatch_release_ordered<UT>(
+          gtid, &sh->u.s.ordered_iteration,
+          (UT)test_then_inc<ST>((volatile ST *)&sh->u.s.ordered_iteration) +
+              1);
     } // if
   } // if
   KD_TRACE(100, ("__kmp_dispatch_finish: T#%d returned\n", gtid));
@@ -1105,8 +1901,7 @@ static void __kmp_dispatch_finish_chunk(int gtid, ident_t *loc) {
       }
 #endif
 
-      __kmp_wait<UT>(&sh->u.s.ordered_iteration, lower,
-                     __kmp_ge<UT> USE_ITT_BUILD_ARG(NULL));
+      __kmp_dispatch_wait_ordered<UT>(gtid, &sh->u.s.ordered_iteration, lower);
 
       KMP_MB(); /* is this necessary? */
       KD_TRACE(1000, ("__kmp_dispatch_finish_chunk: T#%d resetting "
@@ -1129,7 +1924,11 @@ static void __kmp_dispatch_finish_chunk(int gtid, ident_t *loc) {
       }
 #endif
 
-      test_then_add<ST>((volatile ST *)&sh->u.s.ordered_iteration, inc);
+      __kmp_dispatch_release_ordered<UT>(
+          gtid, &sh->u.s.ordered_iteration,
+          (UT)test_then_add<ST>((volatile ST *)&sh->u.s.ordered_iteration,
+                                inc) +
+              inc);
     }
     //        }
   }
@@ -1194,9 +1993,9 @@ int __kmp_dispatch_next_algorithm(int gtid,
 
     trip = pr->u.p.tc - 1;
 
-    if (traits_t<T>::type_size > 4) {
-      // use lock for 8-byte and CAS for 4-byte induction
-      // variable. TODO (optional): check and use 16-byte CAS
+    if (traits_t<T>::type_size > 4 && !pr->flags.steal_packed &&
+        !pr->flags.steal_dcas) {
+      // 8-byte chunk numbers without 16-byte CAS: use per-thread lock
       kmp_lock_t *lck = th->th.th_dispatch->th_steal_lock;
       KMP_DEBUG_ASSERT(lck != NULL);
       if (pr->u.p.count < (UT)pr->u.p.ub) {
@@ -1277,34 +2076,21 @@ int __kmp_dispatch_next_algorithm(int gtid,
         } // while (search for victim)
       } // if (try to find victim and steal)
     } else {
-      // 4-byte induction variable, use 8-byte CAS for pair (count, ub)
-      typedef union {
-        struct {
-          UT count;
-          T ub;
-        } p;
-        kmp_int64 b;
-      } union_i4;
-      // All operations on 'count' or 'ub' must be combined atomically
-      // together.
-      {
-        union_i4 vold, vnew;
-        vold.b = *(volatile kmp_int64 *)(&pr->u.p.count);
-        vnew = vold;
-        vnew.p.count++;
-        while (!KMP_COMPARE_AND_STORE_ACQ64(
-            (volatile kmp_int64 *)&pr->u.p.count,
-            *VOLATILE_CAST(kmp_int64 *) & vold.b,
-            *VOLATILE_CAST(kmp_int64 *) & vnew.b)) {
-          KMP_CPU_PAUSE();
-          vold.b = *(volatile kmp_int64 *)(&pr->u.p.count);
-          vnew = vold;
-          vnew.p.count++;
-        }
-        vnew = vold;
-        init = vnew.p.count;
-        status = (init < (UT)vnew.p.ub);
+      // use 8-byte CAS for packed pair (count, ub), or 16-byte CAS for the
+      // pair of 8-byte chunk numbers
+      bool dcas = pr->flags.steal_dcas;
+      kmp_uint64 vold[2], vnew[2];
+      __kmp_steal_pair_load(pr, dcas, vold);
+      while (vold[0] < vold[1]) { // only the owner increments count
+        vnew[0] = vold[0] + 1;
+        vnew[1] = vold[1];
+        if (__kmp_steal_pair_cas(pr, dcas, vold, vnew))
+          break;
+        KMP_CPU_PAUSE();
+        __kmp_steal_pair_load(pr, dcas, vold);
       }
+      init = vold[0];
+      status = (vold[0] < vold[1]);
 
       if (!status) {
         kmp_info_t **other_threads = team->t.t_threads;
@@ -1314,8 +2100,7 @@ int __kmp_dispatch_next_algorithm(int gtid,
         // TODO: algorithm of searching for a victim
         // should be cleaned up and measured
         while ((!status) && (while_limit != ++while_index)) {
-          union_i4 vold, vnew;
-          kmp_int32 remaining;
+          kmp_uint64 remaining;
           T victimIdx = pr->u.p.parm4;
           T oldVictimIdx = victimIdx ? victimIdx - 1 : nproc - 1;
           dispatch_private_info_template<T> *victim =
@@ -1338,47 +2123,41 @@ int __kmp_dispatch_next_algorithm(int gtid,
             // because all victims are still in kmp_init_dispatch
           }
           pr->u.p.parm4 = victimIdx; // new victim found
+          __kmp_steal_pair_load(victim, dcas, vold);
           while (1) { // CAS loop if victim has enough chunks to steal
-            vold.b = *(volatile kmp_int64 *)(&victim->u.p.count);
-            vnew = vold;
+            vnew[0] = vold[0];
+            vnew[1] = vold[1];
 
-            KMP_DEBUG_ASSERT((vnew.p.ub - 1) * (UT)chunk <= trip);
-            if (vnew.p.count >= (UT)vnew.p.ub ||
-                (remaining = vnew.p.ub - vnew.p.count) < 2) {
+            KMP_DEBUG_ASSERT((vnew[1] - 1) * (UT)chunk <= trip);
+            if (vnew[0] >= vnew[1] || (remaining = vnew[1] - vnew[0]) < 2) {
               pr->u.p.parm4 = (victimIdx + 1) % nproc; // shift start victim id
               break; // not enough chunks to steal, goto next victim
             }
             if (remaining > 3) {
-              vnew.p.ub -= (remaining >> 2); // try to steal 1/4 of remaining
+              vnew[1] -= (remaining >> 2); // try to steal 1/4 of remaining
             } else {
-              vnew.p.ub -= 1; // steal 1 chunk of 2 or 3 remaining
+              vnew[1] -= 1; // steal 1 chunk of 2 or 3 remaining
             }
-            KMP_DEBUG_ASSERT((vnew.p.ub - 1) * (UT)chunk <= trip);
-            // TODO: Should this be acquire or release?
-            if (KMP_COMPARE_AND_STORE_ACQ64(
-                    (volatile kmp_int64 *)&victim->u.p.count,
-                    *VOLATILE_CAST(kmp_int64 *) & vold.b,
-                    *VOLATILE_CAST(kmp_int64 *) & vnew.b)) {
+            KMP_DEBUG_ASSERT((vnew[1] - 1) * (UT)chunk <= trip);
+            if (__kmp_steal_pair_cas(victim, dcas, vold, vnew)) {
               // stealing succedded
               KMP_COUNT_DEVELOPER_VALUE(FOR_static_steal_stolen,
-                                        vold.p.ub - vnew.p.ub);
+                                        vold[1] - vnew[1]);
               status = 1;
               while_index = 0;
               // now update own count and ub
-              init = vnew.p.ub;
-              vold.p.count = init + 1;
-#if KMP_ARCH_X86
-              KMP_XCHG_FIXED64((volatile kmp_int64 *)(&pr->u.p.count), vold.b);
-#else
-              *(volatile kmp_int64 *)(&pr->u.p.count) = vold.b;
-#endif
+              init = vnew[1];
+              vnew[0] = init + 1;
+              vnew[1] = vold[1];
+              __kmp_steal_pair_store(pr, dcas, vnew);
               break;
             } // if (check CAS result)
             KMP_CPU_PAUSE(); // CAS failed, repeate attempt
+            __kmp_steal_pair_load(victim, dcas, vold);
           } // while (try to steal from particular victim)
         } // while (search for victim)
       } // if (try to find victim and steal)
-    } // if (4-byte induction variable)
+    } // if (CAS on the pair)
     if (!status) {
       *p_lb = 0;
       *p_ub = 0;
@@ -1481,7 +2260,25 @@ int __kmp_dispatch_next_algorithm(int gtid,
         ("__kmp_dispatch_next_algorithm: T#%d kmp_sch_dynamic_chunked case\n",
          gtid));
 
-    init = chunk * test_then_inc_acq<ST>((volatile ST *)&sh->u.s.iteration);
+    if (pr->u.p.parm4 > 1) {
+      if (pr->u.p.parm2 >= pr->u.p.parm3) {
+        // Grab a batch of chunks sized to the chunks left when this thread
+        // last looked, so that the tail of the loop still balances.
+        UT chunks = pr->u.p.tc / chunk + (pr->u.p.tc % chunk ? 1 : 0);
+        UT left = chunks > (UT)pr->u.p.parm3 ? chunks - pr->u.p.parm3 : 0;
+        T batch = (T)(left / ((UT)nproc * 4));
+        if (batch > pr->u.p.parm4)
+          batch = pr->u.p.parm4;
+        else if (batch < 1)
+          batch = 1;
+        pr->u.p.parm2 =
+            test_then_add<ST>((volatile ST *)&sh->u.s.iteration, (ST)batch);
+        pr->u.p.parm3 = pr->u.p.parm2 + batch;
+      }
+      init = chunk * pr->u.p.parm2++;
+    } else {
+      init = chunk * test_then_inc_acq<ST>((volatile ST *)&sh->u.s.iteration);
+    }
     trip = pr->u.p.tc - 1;
 
     if ((status = (init <= trip)) == 0) {
@@ -2048,7 +2845,12 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
     // status == 0: no more iterations to execute
     if (status == 0) {
       UT num_done;
+      kmp_auto_loop_t *auto_loop = (kmp_auto_loop_t *)TCR_PTR(sh->auto_loop);
 
+      if (auto_loop != NULL && auto_loop != KMP_AUTO_LOOP_NONE) {
+        int tid = th->th.th_info.ds.ds_tid;
+        auto_loop->time[tid] = KMP_NOW() - auto_loop->start[tid];
+      }
       num_done = test_then_inc<ST>((volatile ST *)&sh->u.s.num_done);
 #ifdef KMP_DEBUG
       {
@@ -2068,7 +2870,8 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
       if ((ST)num_done == th->th.th_team_nproc - 1) {
 #if (KMP_STATIC_STEAL_ENABLED)
         if (pr->schedule == kmp_sch_static_steal &&
-            traits_t<T>::type_size > 4) {
+            traits_t<T>::type_size > 4 && !pr->flags.steal_packed &&
+            !pr->flags.steal_dcas) {
           int i;
           kmp_info_t **other_threads = team->t.t_threads;
           // loop complete, safe to destroy locks used for stealing
@@ -2085,6 +2888,13 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
 
         KMP_MB(); /* Flush all pending memory write invalidates.  */
 
+        if (auto_loop != NULL) {
+          if (auto_loop != KMP_AUTO_LOOP_NONE) {
+            __kmp_auto_sched_end(auto_loop, gtid);
+            __kmp_fast_free(th, auto_loop);
+          }
+          sh->auto_loop = NULL;
+        }
         sh->u.s.num_done = 0;
         sh->u.s.iteration = 0;
 
@@ -2095,9 +2905,18 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
 
         KMP_MB(); /* Flush all pending memory write invalidates.  */
 
-        sh->buffer_index += __kmp_dispatch_num_buffers;
-        KD_TRACE(100, ("__kmp_dispatch_next: T#%d change buffer_index:%d\n",
-                       gtid, sh->buffer_index));
+        if (__kmp_dispatch_in_ring(team, sh)) {
+          // atomic: a loop of this slot that ran in an overflow buffer may
+          // finish at the same time
+          KMP_TEST_THEN_ADD32((volatile kmp_int32 *)&sh->buffer_index,
+                              __kmp_dispatch_num_buffers);
+          KD_TRACE(100, ("__kmp_dispatch_next: T#%d change buffer_index:%d\n",
+                         gtid, sh->buffer_index));
+        } else {
+          __kmp_dispatch_release_overflow(
+              team, CCAST(kmp_disp_overflow_t *,
+                          (volatile kmp_disp_overflow_t *)sh));
+        }
 
         KMP_MB(); /* Flush all pending memory write invalidates.  */
 
@@ -60,6 +60,10 @@ extern int __kmp_dispatch_next_algorithm(
 
 void __kmp_dispatch_dxo_error(int *gtid_ref, int *cid_ref, ident_t *loc_ref);
 void __kmp_dispatch_deo_error(int *gtid_ref, int *cid_ref, ident_t *loc_ref);
+void __kmp_dispatch_ordered_wait(int gtid, volatile void *ordered_iteration,
+                                 int size, kmp_uint64 lower);
+void __kmp_dispatch_ordered_release(int gtid, volatile void *ordered_iteration,
+                                    kmp_uint64 iter);
 
 #if KMP_STATIC_STEAL_ENABLED
 
@@ -174,6 +178,9 @@ template <typename T> struct dispatch_shared_info_template {
   volatile kmp_int32 doacross_buf_idx; // teamwise index
   kmp_uint32 *doacross_flags; // array of iteration flags (0/1)
   kmp_int32 doacross_num_done; // count finished threads
+  kmp_int32 doacross_sleepers; // threads sleeping in doacross waits
+  void *volatile auto_loop; // adaptive schedule(auto) instance
+  volatile kmp_uint64 ring_claim; // elastic ring: loops decided for the slot
 #if KMP_USE_HIER_SCHED
   kmp_hier_t<T> *hier;
 #endif
@@ -315,6 +322,25 @@ static UT __kmp_wait(volatile UT *spinner, UT checker,
 /* ------------------------------------------------------------------------ */
 /* ------------------------------------------------------------------------ */
 
+// Ordered loops hand the turn from thread to thread: a thread that has to
+// wait for ordered_iteration to reach its chunk spins on a record of its own,
+// and the thread that moves ordered_iteration there wakes it up.
+template <typename UT>
+static __forceinline void
+__kmp_dispatch_wait_ordered(int gtid, volatile UT *ordered_iteration,
+                            UT lower) {
+  if (*ordered_iteration < lower)
+    __kmp_dispatch_ordered_wait(gtid, ordered_iteration, sizeof(UT), lower);
+}
+
+template <typename UT>
+static __forceinline void
+__kmp_dispatch_release_ordered(int gtid, volatile UT *ordered_iteration,
+                               UT iter) {
+  if (__kmp_threads[gtid]->th.th_team->t.t_ordered_waiters != NULL)
+    __kmp_dispatch_ordered_release(gtid, ordered_iteration, iter);
+}
+
 template <typename UT>
 void __kmp_dispatch_deo(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
   dispatch_private_info_template<UT> *pr;
@@ -372,8 +398,7 @@ void __kmp_dispatch_deo(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
       __kmp_str_free(&buff);
     }
 #endif
-    __kmp_wait<UT>(&sh->u.s.ordered_iteration, lower,
-                   __kmp_ge<UT> USE_ITT_BUILD_ARG(NULL));
+    __kmp_dispatch_wait_ordered<UT>(gtid, &sh->u.s.ordered_iteration, lower);
     KMP_MB(); /* is this necessary? */
 #ifdef KMP_DEBUG
     {
@@ -443,7 +468,9 @@ void __kmp_dispatch_dxo(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
     KMP_MB(); /* Flush all pending memory write invalidates.  */
 
     /* TODO use general release procedure? */
-    test_then_inc<ST>((volatile ST *)&sh->u.s.ordered_iteration);
+    __kmp_dispatch_release_ordered<UT>(
+        gtid, &sh->u.s.ordered_iteration,
+        (UT)test_then_inc<ST>((volatile ST *)&sh->u.s.ordered_iteration) + 1);
 
     KMP_MB(); /* Flush all pending memory write invalidates.  */
   }
@@ -932,8 +932,9 @@ void FTN_STDCALL KMP_EXPAND_NAME(FTN_SET_DEFAULT_DEVICE)(int KMP_DEREF arg) {
 #if KMP_MIC || KMP_OS_DARWIN || defined(KMP_STUB)
 // Nothing.
 #else
-  __kmp_entry_thread()->th.th_current_task->td_icvs.default_device =
-      KMP_DEREF arg;
+  kmp_taskdata_t *task = __kmp_entry_thread()->th.th_current_task;
+  task->td_icvs.default_device = KMP_DEREF arg;
+  KMP_ICVS_CHANGED(task);
 #endif
 }
 
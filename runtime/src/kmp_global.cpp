@@ -128,13 +128,23 @@ int __kmp_dflt_team_nth_ub = 0;
 int __kmp_tp_capacity = 0;
 int __kmp_tp_cached = 0;
 int __kmp_dispatch_num_buffers = KMP_DFLT_DISP_NUM_BUFF;
+int __kmp_dispatch_elastic = FALSE; /* run ahead of a busy dispatch buffer */
+/* static_steal (count, ub) updates: 0 - packed into 8 bytes when the chunk
+   numbers fit, 1 - never packed, 2 - neither packed nor 16-byte CAS (lock) */
+int __kmp_steal_pair = 0;
+int __kmp_doacross_window = KMP_DFLT_DOACROSS_WINDOW; /* iterations */
+int __kmp_dist_elem_size = 0; /* bytes per iteration, 0: no page alignment */
 int __kmp_dflt_max_active_levels = 1; // Nesting off by default
 bool __kmp_dflt_max_active_levels_set = false; // Don't override set value
 #if KMP_NESTED_HOT_TEAMS
 int __kmp_hot_teams_mode = 0; /* 0 - free extra threads when reduced */
 /* 1 - keep extra threads when reduced */
 int __kmp_hot_teams_max_level = 1; /* nesting level of hot teams */
+int __kmp_nested_teams_cache = 0; /* max inner teams parked per root */
 #endif
+int __kmp_fast_fork = TRUE; /* reuse an unchanged hot team without setup */
+int __kmp_prespawn_threads = 0; /* 0 - create workers at the first fork */
+/* 1 - create them at initialization, 2 - on a helper thread */
 enum library_type __kmp_library = library_none;
 enum sched_type __kmp_sched =
     kmp_sch_default; /* scheduling method for runtime scheduling */
@@ -144,8 +154,12 @@ enum sched_type __kmp_guided =
     kmp_sch_guided_iterative_chunked; /* default guided scheduling method */
 enum sched_type __kmp_auto =
     kmp_sch_guided_analytical_chunked; /* default auto scheduling method */
+int __kmp_adaptive_auto = FALSE; /* tune schedule(auto) loops per call site */
+int __kmp_dispatch_chunk_batch = 1; /* dynamic chunks grabbed at once */
 #if KMP_USE_HIER_SCHED
 int __kmp_dispatch_hand_threading = 0;
+int __kmp_dispatch_hier_auto = 32; /* min team size for automatic hierarchy */
+int __kmp_env_disp_hier_auto = FALSE; /* KMP_DISP_HIER_AUTO specified? */
 int __kmp_hier_max_units[kmp_hier_layer_e::LAYER_LAST + 1];
 int __kmp_hier_threads_per[kmp_hier_layer_e::LAYER_LAST + 1];
 kmp_hier_sched_env_t __kmp_hier_scheds = {0, 0, NULL, NULL, NULL};
@@ -343,6 +357,7 @@ int __kmp_forkjoin_frames_mode = 3;
 PACKED_REDUCTION_METHOD_T __kmp_force_reduction_method =
     reduction_method_not_defined;
 int __kmp_determ_red = FALSE;
+int __kmp_fused_reduction_barrier = FALSE;
 
 #ifdef KMP_DEBUG
 int kmp_a_debug = 0;
@@ -39,6 +39,26 @@
 #endif
 #endif
 
+int __kmp_lock_park = FALSE;
+
+#if KMP_USE_LOCK_PARK
+// th_spin_here value of a queuing lock waiter sleeping on it.
+#define KMP_LOCK_PARKED 2
+
+// Time until which a waiter for the lock spins before it parks, taken from the
+// blocktime of its team like for the threads waiting at barriers.
+static kmp_uint64 __kmp_lock_park_goal(kmp_int32 gtid) {
+  kmp_info_t *th = __kmp_threads[gtid];
+  kmp_team_t *team = th->th.th_team;
+  int tid = th->th.th_info.ds.ds_tid;
+  if (__kmp_pause_status == kmp_soft_paused)
+    return KMP_NOW(); // park immediately
+  if (team == NULL || KMP_BLOCKTIME(team, tid) == KMP_MAX_BLOCKTIME)
+    return ~(kmp_uint64)0; // never park
+  return KMP_NOW() + KMP_BLOCKTIME_INTERVAL(team, tid);
+}
+#endif // KMP_USE_LOCK_PARK
+
 /* Implement spin locks for internal library use.             */
 /* The algorithm implemented is Lamport's bakery lock [1974]. */
 
@@ -1237,8 +1257,38 @@ __kmp_acquire_queuing_lock_timed_template(kmp_queuing_lock_t *lck,
                 lck, gtid));
 
       KMP_MB();
-      // ToDo: Use __kmp_wait_sleep or similar when blocktime != inf
-      KMP_WAIT(spin_here_p, FALSE, KMP_EQ, lck);
+#if KMP_USE_LOCK_PARK
+      if (__kmp_lock_park) {
+        // Spin for the blocktime, then sleep on spin_here until the releasing
+        // thread clears it and, having seen KMP_LOCK_PARKED, wakes us.
+        kmp_uint64 goal = __kmp_lock_park_goal(gtid);
+        kmp_uint64 poll_count;
+        kmp_uint32 spins;
+        poll_count = 0;
+        KMP_FSYNC_SPIN_INIT(lck, NULL);
+        KMP_INIT_YIELD(spins);
+        while (TCR_4(*spin_here_p) != FALSE) {
+          if (KMP_BLOCKING(goal, poll_count++)) {
+            KMP_FSYNC_SPIN_PREPARE(lck);
+            KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+            continue;
+          }
+          if (KMP_COMPARE_AND_STORE_RET32(
+                  (volatile kmp_int32 *)spin_here_p, TRUE, KMP_LOCK_PARKED) ==
+              FALSE)
+            break;
+          KA_TRACE(1000, ("__kmp_acquire_queuing_lock: lck:%p, T#%d parking\n",
+                          lck, gtid));
+          while (TCR_4(*spin_here_p) != FALSE)
+            syscall(__NR_futex, spin_here_p, FUTEX_WAIT, KMP_LOCK_PARKED, NULL,
+                    NULL, 0);
+        }
+        KMP_FSYNC_SPIN_ACQUIRED(lck);
+        KMP_MB();
+      } else
+#endif
+        // ToDo: Use __kmp_wait_sleep or similar when blocktime != inf
+        KMP_WAIT(spin_here_p, FALSE, KMP_EQ, lck);
 
 #ifdef DEBUG_QUEUING_LOCKS
       TRACE_LOCK(gtid + 1, "acq spin");
@@ -1477,7 +1527,15 @@ int __kmp_release_queuing_lock(kmp_queuing_lock_t *lck, kmp_int32 gtid) {
 
       KMP_MB();
       /* reset spin value */
-      head_thr->th.th_spin_here = FALSE;
+#if KMP_USE_LOCK_PARK
+      if (__kmp_lock_park) {
+        if (KMP_XCHG_FIXED32(&head_thr->th.th_spin_here, FALSE) ==
+            KMP_LOCK_PARKED)
+          syscall(__NR_futex, &head_thr->th.th_spin_here, FUTEX_WAKE, 1, NULL,
+                  NULL, 0);
+      } else
+#endif
+        head_thr->th.th_spin_here = FALSE;
 
       KA_TRACE(1000, ("__kmp_release_queuing_lock: lck:%p, T#%d exiting: after "
                       "dequeuing\n",
@@ -2229,6 +2287,25 @@ static inline bool __kmp_is_drdpa_lock_nestable(kmp_drdpa_lock_t *lck) {
   return lck->lk.depth_locked != -1;
 }
 
+#if KMP_USE_LOCK_PARK
+// Sleeps on the low half of a poll (its first word on the little-endian targets
+// with futexes) until its ticket changes.  The owner only wakes the parked
+// waiters of the poll it releases, so a waiter that has read the polls just
+// before they were reconfigured may sleep on a poll that is no longer
+// released; the timeout bounds its wait until it rereads the polls.
+static void __kmp_park_drdpa_waiter(kmp_drdpa_lock_t *lck,
+                                    std::atomic<kmp_uint64> *poll,
+                                    kmp_uint64 ticket) {
+  struct timespec timeout = {0, KMP_NSEC_PER_SEC / 100};
+  lck->lk.parked.fetch_add(1);
+  kmp_uint64 value = poll->load();
+  if (value < ticket)
+    syscall(__NR_futex, (kmp_int32 *)poll, FUTEX_WAIT, (kmp_int32)value,
+            &timeout, NULL, 0);
+  lck->lk.parked.fetch_sub(1);
+}
+#endif
+
 __forceinline static int
 __kmp_acquire_drdpa_lock_timed_template(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
   kmp_uint64 ticket = KMP_ATOMIC_INC(&lck->lk.next_ticket);
@@ -2249,10 +2326,21 @@ __kmp_acquire_drdpa_lock_timed_template(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
   // The current implementation of KMP_WAIT doesn't allow for mask
   // and poll to be re-read every spin iteration.
   kmp_uint32 spins;
+#if KMP_USE_LOCK_PARK
+  bool park = __kmp_lock_park && gtid >= 0;
+  kmp_uint64 goal = park ? __kmp_lock_park_goal(gtid) : 0;
+  kmp_uint64 poll_count;
+  poll_count = 0;
+#endif
   KMP_FSYNC_PREPARE(lck);
   KMP_INIT_YIELD(spins);
   while (polls[ticket & mask] < ticket) { // atomic load
-    KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+#if KMP_USE_LOCK_PARK
+    if (park && !KMP_BLOCKING(goal, poll_count++))
+      __kmp_park_drdpa_waiter(lck, &polls[ticket & mask], ticket);
+    else
+#endif
+      KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
     // Re-read the mask and the poll pointer from the lock structure.
     //
     // Make certain that "mask" is read before "polls" !!!
@@ -2288,12 +2376,15 @@ __kmp_acquire_drdpa_lock_timed_template(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
     bool reconfigure = false;
     std::atomic<kmp_uint64> *old_polls = polls;
     kmp_uint32 num_polls = TCR_4(lck->lk.num_polls);
+    kmp_uint32 old_num_polls = num_polls;
 
     if (TCR_4(__kmp_nth) >
         (__kmp_avail_proc ? __kmp_avail_proc : __kmp_xproc)) {
       // We are in oversubscription mode.  Contract the polling area
       // down to a single location, if that hasn't been done already.
-      if (num_polls > 1) {
+      // Parked waiters do not take the processors from the owner, so they
+      // keep their polls and the owner keeps waking only the next one.
+      if (num_polls > 1 && !__kmp_lock_park) {
         reconfigure = true;
         num_polls = TCR_4(lck->lk.num_polls);
         mask = 0;
@@ -2308,7 +2399,6 @@ __kmp_acquire_drdpa_lock_timed_template(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
       // should be at least the number of threads waiting.
       kmp_uint64 num_waiting = TCR_8(lck->lk.next_ticket) - ticket - 1;
       if (num_waiting > num_polls) {
-        kmp_uint32 old_num_polls = num_polls;
         reconfigure = true;
         do {
           mask = (mask << 1) | 1;
@@ -2357,6 +2447,16 @@ __kmp_acquire_drdpa_lock_timed_template(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
       //
       // volatile load / non-volatile store
       lck->lk.cleanup_ticket = lck->lk.next_ticket;
+
+#if KMP_USE_LOCK_PARK
+      // Let the waiters parked on the old polls reread the new ones.
+      if (lck->lk.parked.load() != 0) {
+        kmp_uint32 i;
+        for (i = 0; i < old_num_polls; i++)
+          syscall(__NR_futex, (kmp_int32 *)&old_polls[i], FUTEX_WAKE, INT_MAX,
+                  NULL, NULL, 0);
+      }
+#endif
     }
   }
   return KMP_LOCK_ACQUIRED_FIRST;
@@ -2443,6 +2543,13 @@ int __kmp_release_drdpa_lock(kmp_drdpa_lock_t *lck, kmp_int32 gtid) {
   KMP_FSYNC_RELEASING(lck);
   ANNOTATE_DRDPA_RELEASED(lck);
   polls[ticket & mask] = ticket; // atomic store
+#if KMP_USE_LOCK_PARK
+  // Polls are shared by waiters only while the polling area is smaller than
+  // the number of waiters, so this mostly wakes just the next owner.
+  if (__kmp_lock_park && lck->lk.parked.load() != 0)
+    syscall(__NR_futex, (kmp_int32 *)&polls[ticket & mask], FUTEX_WAKE, INT_MAX,
+            NULL, NULL, 0);
+#endif
   return KMP_LOCK_RELEASED;
 }
 
@@ -2479,6 +2586,7 @@ void __kmp_init_drdpa_lock(kmp_drdpa_lock_t *lck) {
   lck->lk.now_serving = 0;
   lck->lk.owner_id = 0; // no thread owns the lock.
   lck->lk.depth_locked = -1; // >= 0 for nestable locks, -1 for simple locks.
+  lck->lk.parked = 0;
   lck->lk.initialized = lck;
 
   KA_TRACE(1000, ("__kmp_init_drdpa_lock: lock %p initialized\n", lck));
@@ -2837,6 +2945,573 @@ static int __kmp_test_rtm_lock_with_checks(kmp_queuing_lock_t *lck,
 
 #endif // KMP_USE_TSX
 
+// Cohort lock functions.
+int __kmp_cohort_handoffs = 64;
+
+#if KMP_OS_LINUX
+static int __kmp_read_cpu_package(int cpu) {
+  char path[256];
+  unsigned pkg = 0;
+  KMP_SNPRINTF(path, sizeof(path),
+               "/sys/devices/system/cpu/cpu%d/topology/physical_package_id",
+               cpu);
+  if (__kmp_read_from_file(path, "%u", &pkg) != 1)
+    pkg = 0;
+  return (int)pkg;
+}
+#endif
+
+int __kmp_cohort_num_nodes(void) {
+  static int num_nodes = 0;
+  if (num_nodes == 0) {
+    int n = 1;
+#if KMP_OS_LINUX
+    for (int cpu = 0; cpu < __kmp_xproc; ++cpu) {
+      int pkg = __kmp_read_cpu_package(cpu);
+      if (pkg >= n)
+        n = pkg + 1;
+    }
+#endif
+    num_nodes = n;
+  }
+  return num_nodes;
+}
+
+// The node of a thread is the package of the processor it ran on when it
+// first took a cohort lock, cached as node + 1 in th_lock_node. A thread that
+// migrates later still takes the lock correctly, only with more traffic
+// between the nodes.
+static kmp_int32 __kmp_get_cohort_node(kmp_int32 gtid) {
+  kmp_info_t *th = __kmp_threads[gtid];
+  kmp_int32 node = th->th.th_lock_node;
+  if (node == 0) {
+    int pkg = 0;
+#if KMP_OS_LINUX
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+      pkg = __kmp_read_cpu_package(cpu);
+#endif
+    node = pkg % KMP_COHORT_NODES + 1;
+    th->th.th_lock_node = node;
+  }
+  return node - 1;
+}
+
+static void __kmp_init_cohort_lock(kmp_cohort_lock_t *lck) {
+  lck->lk.location = NULL;
+  lck->lk.owner_id = 0;
+  lck->lk.owner_node = 0;
+  __kmp_init_ticket_lock(&lck->lk.global);
+  for (int i = 0; i < KMP_COHORT_NODES; ++i) {
+    __kmp_init_queuing_lock(&lck->lk.nodes[i].local);
+    lck->lk.nodes[i].has_global = FALSE;
+    lck->lk.nodes[i].handoffs = 0;
+  }
+  lck->lk.initialized = lck;
+  KA_TRACE(1000, ("__kmp_init_cohort_lock: lock %p initialized\n", lck));
+}
+
+static void __kmp_destroy_cohort_lock(kmp_cohort_lock_t *lck) {
+  lck->lk.initialized = NULL;
+  lck->lk.location = NULL;
+  lck->lk.owner_id = 0;
+  __kmp_destroy_ticket_lock(&lck->lk.global);
+  for (int i = 0; i < KMP_COHORT_NODES; ++i)
+    __kmp_destroy_queuing_lock(&lck->lk.nodes[i].local);
+}
+
+static void __kmp_destroy_cohort_lock_with_checks(kmp_cohort_lock_t *lck) {
+  char const *const func = "omp_destroy_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id != 0) {
+    KMP_FATAL(LockStillOwned, func);
+  }
+  __kmp_destroy_cohort_lock(lck);
+}
+
+static int __kmp_acquire_cohort_lock(kmp_cohort_lock_t *lck, kmp_int32 gtid) {
+  kmp_int32 node = __kmp_get_cohort_node(gtid);
+  kmp_cohort_node_t *n = &lck->lk.nodes[node];
+
+  __kmp_acquire_queuing_lock(&n->local, gtid);
+  if (n->has_global) {
+    n->has_global = FALSE; // the previous owner of this node passed it on
+  } else {
+    __kmp_acquire_ticket_lock(&lck->lk.global, gtid);
+  }
+  lck->lk.owner_node = node;
+  return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int __kmp_acquire_cohort_lock_with_checks(kmp_cohort_lock_t *lck,
+                                                 kmp_int32 gtid) {
+  char const *const func = "omp_set_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id - 1 == gtid) {
+    KMP_FATAL(LockIsAlreadyOwned, func);
+  }
+  __kmp_acquire_cohort_lock(lck, gtid);
+  lck->lk.owner_id = gtid + 1;
+  return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int __kmp_test_cohort_lock(kmp_cohort_lock_t *lck, kmp_int32 gtid) {
+  kmp_int32 node = __kmp_get_cohort_node(gtid);
+  kmp_cohort_node_t *n = &lck->lk.nodes[node];
+
+  if (!__kmp_test_queuing_lock(&n->local, gtid))
+    return FALSE;
+  if (n->has_global) {
+    n->has_global = FALSE;
+  } else if (!__kmp_test_ticket_lock(&lck->lk.global, gtid)) {
+    __kmp_release_queuing_lock(&n->local, gtid);
+    return FALSE;
+  }
+  lck->lk.owner_node = node;
+  return TRUE;
+}
+
+static int __kmp_test_cohort_lock_with_checks(kmp_cohort_lock_t *lck,
+                                              kmp_int32 gtid) {
+  char const *const func = "omp_test_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  int retval = __kmp_test_cohort_lock(lck, gtid);
+  if (retval)
+    lck->lk.owner_id = gtid + 1;
+  return retval;
+}
+
+static int __kmp_release_cohort_lock(kmp_cohort_lock_t *lck, kmp_int32 gtid) {
+  kmp_cohort_node_t *n = &lck->lk.nodes[lck->lk.owner_node];
+
+  // A positive head_id is the first thread queued on the local lock, which
+  // the queuing lock hands the lock to next.
+  if (TCR_4(n->local.lk.head_id) > 0 &&
+      n->handoffs < (kmp_uint32)__kmp_cohort_handoffs) {
+    n->handoffs++;
+    n->has_global = TRUE;
+  } else {
+    n->handoffs = 0;
+    __kmp_release_ticket_lock(&lck->lk.global, gtid);
+  }
+  __kmp_release_queuing_lock(&n->local, gtid);
+  return KMP_LOCK_RELEASED;
+}
+
+static int __kmp_release_cohort_lock_with_checks(kmp_cohort_lock_t *lck,
+                                                 kmp_int32 gtid) {
+  char const *const func = "omp_unset_lock";
+  KMP_MB(); /* in case another processor initialized lock */
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id == 0) {
+    KMP_FATAL(LockUnsettingFree, func);
+  }
+  if (lck->lk.owner_id - 1 != gtid) {
+    KMP_FATAL(LockUnsettingSetByAnother, func);
+  }
+  lck->lk.owner_id = 0;
+  return __kmp_release_cohort_lock(lck, gtid);
+}
+
+static const ident_t *__kmp_get_cohort_lock_location(kmp_cohort_lock_t *lck) {
+  return lck->lk.location;
+}
+
+static void __kmp_set_cohort_lock_location(kmp_cohort_lock_t *lck,
+                                           const ident_t *loc) {
+  lck->lk.location = loc;
+}
+
+// Number of lock sites in the lock profile, 0 if profiling is disabled.
+int __kmp_lock_profile = 0;
+
+// Offset of the profile from the base lock object, per indirect lock type.
+static kmp_uint32 __kmp_lock_profile_offset[KMP_NUM_I_LOCKS] = {0};
+
+#define KMP_LOCK_PROFILE(lck, tag)                                             \
+  ((kmp_lock_profile_t *)((char *)(lck) + __kmp_lock_profile_offset[tag]))
+
+// Hybrid lock functions.
+#define KMP_HYBRID_SWITCHING (-(1 << 30)) // bias of users while switching
+
+static void __kmp_init_hybrid_lock(kmp_hybrid_lock_t *lck) {
+  lck->lk.location = NULL;
+  lck->lk.owner_id = 0;
+  lck->lk.queued = FALSE;
+  lck->lk.users = 0;
+  lck->lk.contention = 0;
+  __kmp_init_tas_lock(&lck->lk.tas);
+  __kmp_init_queuing_lock(&lck->lk.queue);
+  lck->lk.cohort = NULL;
+  if (__kmp_cohort_num_nodes() > 1) {
+    lck->lk.cohort =
+        (kmp_cohort_lock_t *)__kmp_allocate(sizeof(kmp_cohort_lock_t));
+    __kmp_init_cohort_lock(lck->lk.cohort);
+  }
+  lck->lk.initialized = lck;
+  KA_TRACE(1000, ("__kmp_init_hybrid_lock: lock %p initialized\n", lck));
+}
+
+static void __kmp_destroy_hybrid_lock(kmp_hybrid_lock_t *lck) {
+  lck->lk.initialized = NULL;
+  lck->lk.location = NULL;
+  lck->lk.owner_id = 0;
+  __kmp_destroy_tas_lock(&lck->lk.tas);
+  __kmp_destroy_queuing_lock(&lck->lk.queue);
+  if (lck->lk.cohort != NULL) {
+    __kmp_destroy_cohort_lock(lck->lk.cohort);
+    __kmp_free(lck->lk.cohort);
+    lck->lk.cohort = NULL;
+  }
+}
+
+static void __kmp_destroy_hybrid_lock_with_checks(kmp_hybrid_lock_t *lck) {
+  char const *const func = "omp_destroy_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id != 0) {
+    KMP_FATAL(LockStillOwned, func);
+  }
+  __kmp_destroy_hybrid_lock(lck);
+}
+
+// Registers the thread as a user of the lock, waiting while the owner
+// switches the lock, and returns the number of other users.
+static kmp_int32 __kmp_enter_hybrid_lock(kmp_hybrid_lock_t *lck) {
+  kmp_int32 prev = KMP_ATOMIC_INC(&lck->lk.users);
+  if (prev < 0) {
+    kmp_uint32 spins;
+    KMP_INIT_YIELD(spins);
+    do {
+      KMP_ATOMIC_DEC(&lck->lk.users);
+      while (KMP_ATOMIC_LD_ACQ(&lck->lk.users) < 0)
+        KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+      prev = KMP_ATOMIC_INC(&lck->lk.users);
+    } while (prev < 0);
+  }
+  return prev;
+}
+
+// Updates the contention estimate after an acquisition.
+static void __kmp_hybrid_lock_acquired(kmp_hybrid_lock_t *lck,
+                                       kmp_int32 others) {
+  kmp_uint32 c = lck->lk.contention;
+  c -= c >> KMP_HYBRID_DECAY;
+  if (others > 0)
+    c += KMP_HYBRID_ONE >> KMP_HYBRID_DECAY;
+  lck->lk.contention = c;
+}
+
+static int __kmp_acquire_hybrid_lock(kmp_hybrid_lock_t *lck, kmp_int32 gtid) {
+  kmp_int32 others = __kmp_enter_hybrid_lock(lck);
+  if (!TCR_4(lck->lk.queued))
+    __kmp_acquire_tas_lock(&lck->lk.tas, gtid);
+  else if (lck->lk.cohort != NULL)
+    __kmp_acquire_cohort_lock(lck->lk.cohort, gtid);
+  else
+    __kmp_acquire_queuing_lock(&lck->lk.queue, gtid);
+  __kmp_hybrid_lock_acquired(lck, others);
+  return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int __kmp_acquire_hybrid_lock_with_checks(kmp_hybrid_lock_t *lck,
+                                                 kmp_int32 gtid) {
+  char const *const func = "omp_set_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id - 1 == gtid) {
+    KMP_FATAL(LockIsAlreadyOwned, func);
+  }
+  __kmp_acquire_hybrid_lock(lck, gtid);
+  lck->lk.owner_id = gtid + 1;
+  return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int __kmp_test_hybrid_lock(kmp_hybrid_lock_t *lck, kmp_int32 gtid) {
+  kmp_int32 others = __kmp_enter_hybrid_lock(lck);
+  int retval;
+  if (!TCR_4(lck->lk.queued))
+    retval = __kmp_test_tas_lock(&lck->lk.tas, gtid);
+  else if (lck->lk.cohort != NULL)
+    retval = __kmp_test_cohort_lock(lck->lk.cohort, gtid);
+  else
+    retval = __kmp_test_queuing_lock(&lck->lk.queue, gtid);
+  if (retval)
+    __kmp_hybrid_lock_acquired(lck, others);
+  else
+    KMP_ATOMIC_DEC(&lck->lk.users);
+  return retval;
+}
+
+static int __kmp_test_hybrid_lock_with_checks(kmp_hybrid_lock_t *lck,
+                                              kmp_int32 gtid) {
+  char const *const func = "omp_test_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  int retval = __kmp_test_hybrid_lock(lck, gtid);
+  if (retval)
+    lck->lk.owner_id = gtid + 1;
+  return retval;
+}
+
+static void __kmp_release_hybrid_inner(kmp_hybrid_lock_t *lck,
+                                       kmp_int32 gtid) {
+  if (!lck->lk.queued)
+    __kmp_release_tas_lock(&lck->lk.tas, gtid);
+  else if (lck->lk.cohort != NULL)
+    __kmp_release_cohort_lock(lck->lk.cohort, gtid);
+  else
+    __kmp_release_queuing_lock(&lck->lk.queue, gtid);
+}
+
+static int __kmp_release_hybrid_lock(kmp_hybrid_lock_t *lck, kmp_int32 gtid) {
+  kmp_uint32 c = lck->lk.contention;
+  kmp_int32 queued = lck->lk.queued;
+  if ((queued ? c < KMP_HYBRID_DOWNGRADE : c > KMP_HYBRID_UPGRADE) &&
+      KMP_ATOMIC_LD_RLX(&lck->lk.users) == 1 &&
+      __kmp_atomic_compare_store(&lck->lk.users, 1,
+                                 1 + KMP_HYBRID_SWITCHING)) {
+    // Nobody else uses the lock until users is restored
+    if (__kmp_lock_profile)
+      KMP_LOCK_PROFILE(lck, locktag_hybrid)->switches++;
+    __kmp_release_hybrid_inner(lck, gtid);
+    lck->lk.queued = !queued;
+    KA_TRACE(1000, ("__kmp_release_hybrid_lock: lock %p switched to %s\n", lck,
+                    queued ? "tas" : "queuing"));
+    KMP_ATOMIC_SUB(&lck->lk.users, 1 + KMP_HYBRID_SWITCHING);
+    return KMP_LOCK_RELEASED;
+  }
+  __kmp_release_hybrid_inner(lck, gtid);
+  KMP_ATOMIC_DEC(&lck->lk.users);
+  return KMP_LOCK_RELEASED;
+}
+
+static int __kmp_release_hybrid_lock_with_checks(kmp_hybrid_lock_t *lck,
+                                                 kmp_int32 gtid) {
+  char const *const func = "omp_unset_lock";
+  KMP_MB(); /* in case another processor initialized lock */
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.owner_id == 0) {
+    KMP_FATAL(LockUnsettingFree, func);
+  }
+  if (lck->lk.owner_id - 1 != gtid) {
+    KMP_FATAL(LockUnsettingSetByAnother, func);
+  }
+  lck->lk.owner_id = 0;
+  return __kmp_release_hybrid_lock(lck, gtid);
+}
+
+static const ident_t *__kmp_get_hybrid_lock_location(kmp_hybrid_lock_t *lck) {
+  return lck->lk.location;
+}
+
+static void __kmp_set_hybrid_lock_location(kmp_hybrid_lock_t *lck,
+                                           const ident_t *loc) {
+  lck->lk.location = loc;
+}
+
+// Reader-writer lock functions.
+// The count of a reader and the writer field are stored before the other is
+// loaded, so both sides use sequentially consistent operations: either the
+// reader sees the writer and steps back, or the writer sees the count.
+static std::atomic<kmp_int32> *__kmp_get_rw_lock_readers(kmp_rw_lock_t *lck,
+                                                         kmp_int32 gtid) {
+  kmp_int32 slot = __kmp_cohort_num_nodes() > 1
+                       ? __kmp_get_cohort_node(gtid)
+                       : gtid % KMP_RW_LOCK_SLOTS;
+  return &lck->lk.slots[slot].readers;
+}
+
+static int __kmp_rw_lock_has_readers(kmp_rw_lock_t *lck) {
+  for (int i = 0; i < KMP_RW_LOCK_SLOTS; ++i)
+    if (lck->lk.slots[i].readers.load() != 0)
+      return TRUE;
+  return FALSE;
+}
+
+static void __kmp_init_rw_lock(kmp_rw_lock_t *lck) {
+  lck->lk.location = NULL;
+  lck->lk.writer = 0;
+  for (int i = 0; i < KMP_RW_LOCK_SLOTS; ++i)
+    lck->lk.slots[i].readers = 0;
+  lck->lk.initialized = lck;
+  KA_TRACE(1000, ("__kmp_init_rw_lock: lock %p initialized\n", lck));
+}
+
+static void __kmp_destroy_rw_lock(kmp_rw_lock_t *lck) {
+  lck->lk.initialized = NULL;
+  lck->lk.location = NULL;
+  lck->lk.writer = 0;
+}
+
+static void __kmp_destroy_rw_lock_with_checks(kmp_rw_lock_t *lck) {
+  char const *const func = "kmpc_destroy_rw_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (lck->lk.writer != 0 || __kmp_rw_lock_has_readers(lck)) {
+    KMP_FATAL(LockStillOwned, func);
+  }
+  __kmp_destroy_rw_lock(lck);
+}
+
+static int __kmp_acquire_rw_lock(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  kmp_uint32 spins;
+  kmp_int32 none = 0;
+  KMP_INIT_YIELD(spins);
+  while (KMP_ATOMIC_LD_RLX(&lck->lk.writer) != 0 ||
+         !lck->lk.writer.compare_exchange_strong(none, gtid + 1)) {
+    none = 0;
+    KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+  }
+  // New readers step back now, wait for the ones inside to leave
+  while (__kmp_rw_lock_has_readers(lck))
+    KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+  return KMP_LOCK_ACQUIRED_FIRST;
+}
+
+static int __kmp_acquire_rw_lock_with_checks(kmp_rw_lock_t *lck,
+                                             kmp_int32 gtid) {
+  char const *const func = "kmpc_set_wr_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (KMP_ATOMIC_LD_RLX(&lck->lk.writer) - 1 == gtid) {
+    KMP_FATAL(LockIsAlreadyOwned, func);
+  }
+  return __kmp_acquire_rw_lock(lck, gtid);
+}
+
+static int __kmp_test_rw_lock(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  kmp_int32 none = 0;
+  if (KMP_ATOMIC_LD_RLX(&lck->lk.writer) != 0 ||
+      !lck->lk.writer.compare_exchange_strong(none, gtid + 1))
+    return FALSE;
+  if (__kmp_rw_lock_has_readers(lck)) {
+    KMP_ATOMIC_ST_REL(&lck->lk.writer, 0);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static int __kmp_test_rw_lock_with_checks(kmp_rw_lock_t *lck,
+                                          kmp_int32 gtid) {
+  char const *const func = "kmpc_test_wr_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  return __kmp_test_rw_lock(lck, gtid);
+}
+
+static int __kmp_release_rw_lock(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  KMP_ATOMIC_ST_REL(&lck->lk.writer, 0);
+  return KMP_LOCK_RELEASED;
+}
+
+static int __kmp_release_rw_lock_with_checks(kmp_rw_lock_t *lck,
+                                             kmp_int32 gtid) {
+  char const *const func = "kmpc_unset_wr_lock";
+  KMP_MB(); /* in case another processor initialized lock */
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (KMP_ATOMIC_LD_RLX(&lck->lk.writer) == 0) {
+    KMP_FATAL(LockUnsettingFree, func);
+  }
+  if (KMP_ATOMIC_LD_RLX(&lck->lk.writer) - 1 != gtid) {
+    KMP_FATAL(LockUnsettingSetByAnother, func);
+  }
+  return __kmp_release_rw_lock(lck, gtid);
+}
+
+int __kmp_acquire_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  std::atomic<kmp_int32> *readers = __kmp_get_rw_lock_readers(lck, gtid);
+  kmp_uint32 spins;
+  KMP_INIT_YIELD(spins);
+  for (;;) {
+    while (KMP_ATOMIC_LD_ACQ(&lck->lk.writer) != 0)
+      KMP_YIELD_OVERSUB_ELSE_SPIN(spins);
+    readers->fetch_add(1);
+    if (lck->lk.writer.load() == 0)
+      return KMP_LOCK_ACQUIRED_FIRST;
+    KMP_ATOMIC_DEC(readers); // a writer came first, let it go ahead
+  }
+}
+
+int __kmp_acquire_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                             kmp_int32 gtid) {
+  char const *const func = "kmpc_set_rd_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  if (KMP_ATOMIC_LD_RLX(&lck->lk.writer) - 1 == gtid) {
+    KMP_FATAL(LockIsAlreadyOwned, func);
+  }
+  return __kmp_acquire_rw_lock_shared(lck, gtid);
+}
+
+int __kmp_test_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  std::atomic<kmp_int32> *readers = __kmp_get_rw_lock_readers(lck, gtid);
+  if (KMP_ATOMIC_LD_ACQ(&lck->lk.writer) != 0)
+    return FALSE;
+  readers->fetch_add(1);
+  if (lck->lk.writer.load() == 0)
+    return TRUE;
+  KMP_ATOMIC_DEC(readers);
+  return FALSE;
+}
+
+int __kmp_test_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                          kmp_int32 gtid) {
+  char const *const func = "kmpc_test_rd_lock";
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  return __kmp_test_rw_lock_shared(lck, gtid);
+}
+
+int __kmp_release_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid) {
+  KMP_ATOMIC_DEC(__kmp_get_rw_lock_readers(lck, gtid));
+  return KMP_LOCK_RELEASED;
+}
+
+int __kmp_release_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                             kmp_int32 gtid) {
+  char const *const func = "kmpc_unset_rd_lock";
+  KMP_MB(); /* in case another processor initialized lock */
+  if (lck->lk.initialized != lck) {
+    KMP_FATAL(LockIsUninitialized, func);
+  }
+  // Readers are not recorded by gtid, only a lock without readers in the
+  // slot of the thread is known to be free
+  if (KMP_ATOMIC_LD_RLX(__kmp_get_rw_lock_readers(lck, gtid)) == 0) {
+    KMP_FATAL(LockUnsettingFree, func);
+  }
+  return __kmp_release_rw_lock_shared(lck, gtid);
+}
+
+static const ident_t *__kmp_get_rw_lock_location(kmp_rw_lock_t *lck) {
+  return lck->lk.location;
+}
+
+static void __kmp_set_rw_lock_location(kmp_rw_lock_t *lck,
+                                       const ident_t *loc) {
+  lck->lk.location = loc;
+}
+
 // Entry functions for indirect locks (first element of direct lock jump tables)
 static void __kmp_init_indirect_lock(kmp_dyna_lock_t *l,
                                      kmp_dyna_lockseq_t tag);
@@ -3001,6 +3676,18 @@ int (*(*__kmp_indirect_test))(kmp_user_lock_p, kmp_int32) = 0;
 // Lock index table.
 kmp_indirect_lock_table_t __kmp_i_lock_table;
 
+// Returns the indirect lock of an index handed out, NULL if its row is not
+// installed yet.
+static kmp_indirect_lock_t *__kmp_find_indirect_lock(kmp_lock_index_t i) {
+  kmp_indirect_lock_t **dir = (kmp_indirect_lock_t **)TCR_PTR(
+      __kmp_i_lock_table.dir[i / KMP_I_LOCK_CHUNK / KMP_I_LOCK_DIR_ROWS]);
+  if (dir == NULL)
+    return NULL;
+  kmp_indirect_lock_t *row = (kmp_indirect_lock_t *)TCR_PTR(
+      dir[i / KMP_I_LOCK_CHUNK % KMP_I_LOCK_DIR_ROWS]);
+  return row == NULL ? NULL : row + i % KMP_I_LOCK_CHUNK;
+}
+
 // Size of indirect locks.
 static kmp_uint32 __kmp_indirect_lock_size[KMP_NUM_I_LOCKS] = {0};
 
@@ -3017,56 +3704,294 @@ kmp_lock_flags_t (*__kmp_indirect_get_flags[KMP_NUM_I_LOCKS])(
 // Use different lock pools for different lock types.
 static kmp_indirect_lock_t *__kmp_indirect_lock_pool[KMP_NUM_I_LOCKS] = {0};
 
+// Lock contention profiling. With KMP_LOCK_PROFILE set, the indirect lock jump
+// tables point at the profiling functions below, which call the regular (or
+// checking) functions through the tables they replaced. Without it nothing
+// in the lock paths changes.
+
+static int (*(*profiled_set))(kmp_user_lock_p, kmp_int32) = 0;
+static int (*(*profiled_unset))(kmp_user_lock_p, kmp_int32) = 0;
+static int (*(*profiled_test))(kmp_user_lock_p, kmp_int32) = 0;
+
+// Profiles of destroyed locks whose objects were reused, and report entries.
+typedef struct kmp_lock_profile_entry {
+  void *lock;
+  kmp_lock_profile_t profile;
+  struct kmp_lock_profile_entry *next;
+} kmp_lock_profile_entry_t;
+
+static kmp_lock_profile_entry_t *__kmp_lock_profile_retired = NULL;
+
+// Book-keeping for the owner after an acquisition; start is the time the
+// thread started waiting for the lock, 0 if it did not wait.
+static void __kmp_lock_profile_acquired(kmp_user_lock_p lck,
+                                        kmp_indirect_locktag_t tag,
+                                        kmp_uint64 start, int first) {
+  kmp_lock_profile_t *p = KMP_LOCK_PROFILE(lck, tag);
+  kmp_uint64 now = __kmp_tsc();
+  if (p->acquires++ == 0 && __kmp_indirect_get_location[tag] != NULL)
+    p->location = __kmp_indirect_get_location[tag](lck);
+  if (start != 0) {
+    p->contended++;
+    p->wait_time += now - start;
+  }
+  if (first)
+    p->hold_start = now;
+}
+
+static int __kmp_acquire_lock_profiled(kmp_user_lock_p lck, kmp_int32 gtid,
+                                       kmp_indirect_locktag_t tag) {
+  kmp_uint64 start = 0;
+  int rc;
+  // Try the lock first to tell the contended acquisitions from the others;
+  // the test functions of nested locks return the new depth.
+  int depth = profiled_test[tag](lck, gtid);
+  if (depth) {
+    rc = depth == 1 ? KMP_LOCK_ACQUIRED_FIRST : KMP_LOCK_ACQUIRED_NEXT;
+  } else {
+    start = __kmp_tsc();
+    rc = profiled_set[tag](lck, gtid);
+  }
+  __kmp_lock_profile_acquired(lck, tag, start, rc == KMP_LOCK_ACQUIRED_FIRST);
+  return rc;
+}
+
+static int __kmp_release_lock_profiled(kmp_user_lock_p lck, kmp_int32 gtid,
+                                       kmp_indirect_locktag_t tag) {
+  kmp_lock_profile_t *p = KMP_LOCK_PROFILE(lck, tag);
+  // The profile belongs to the next owner after the release. An inner release
+  // of a nested lock sees a shorter hold than the final one, so taking the
+  // maximum on every release is still exact.
+  kmp_uint64 hold = __kmp_tsc() - p->hold_start;
+  if (hold > p->max_hold)
+    p->max_hold = hold;
+  return profiled_unset[tag](lck, gtid);
+}
+
+static int __kmp_test_lock_profiled(kmp_user_lock_p lck, kmp_int32 gtid,
+                                    kmp_indirect_locktag_t tag) {
+  int rc = profiled_test[tag](lck, gtid);
+  if (rc)
+    __kmp_lock_profile_acquired(lck, tag, 0, rc == 1);
+  return rc;
+}
+
+#define expand(l, op)                                                          \
+  static int __kmp_##op##_##l##_lock_profiled(kmp_user_lock_p lck,             \
+                                              kmp_int32 gtid) {                \
+    return __kmp_##op##_lock_profiled(lck, gtid, locktag_##l);                 \
+  }
+KMP_FOREACH_I_LOCK(expand, acquire)
+KMP_FOREACH_I_LOCK(expand, release)
+KMP_FOREACH_I_LOCK(expand, test)
+#undef expand
+
+#define expand(l, op) __kmp_##op##_##l##_lock_profiled,
+static int (*indirect_set_profile[])(kmp_user_lock_p, kmp_int32) = {
+    KMP_FOREACH_I_LOCK(expand, acquire)};
+static int (*indirect_unset_profile[])(kmp_user_lock_p, kmp_int32) = {
+    KMP_FOREACH_I_LOCK(expand, release)};
+static int (*indirect_test_profile[])(kmp_user_lock_p, kmp_int32) = {
+    KMP_FOREACH_I_LOCK(expand, test)};
+#undef expand
+
+// Keeps the profile of a destroyed lock before its object is reused.
+static void __kmp_retire_lock_profile(kmp_indirect_lock_t *lck) {
+  kmp_lock_profile_t *p = KMP_LOCK_PROFILE(lck->lock, lck->type);
+  if (p->acquires == 0)
+    return;
+  kmp_lock_profile_entry_t *e =
+      (kmp_lock_profile_entry_t *)__kmp_allocate(sizeof(*e));
+  e->lock = lck->lock;
+  e->profile = *p;
+  e->next = __kmp_lock_profile_retired;
+  __kmp_lock_profile_retired = e;
+  memset(p, 0, sizeof(*p));
+}
+
+static int __kmp_lock_profile_cmp_location(const void *a, const void *b) {
+  const kmp_lock_profile_entry_t *x = (const kmp_lock_profile_entry_t *)a;
+  const kmp_lock_profile_entry_t *y = (const kmp_lock_profile_entry_t *)b;
+  if (x->profile.location != y->profile.location)
+    return (kmp_uintptr_t)x->profile.location <
+                   (kmp_uintptr_t)y->profile.location
+               ? -1
+               : 1;
+  if (x->lock != y->lock)
+    return (kmp_uintptr_t)x->lock < (kmp_uintptr_t)y->lock ? -1 : 1;
+  return 0;
+}
+
+static int __kmp_lock_profile_cmp_wait(const void *a, const void *b) {
+  const kmp_lock_profile_t *x = &((const kmp_lock_profile_entry_t *)a)->profile;
+  const kmp_lock_profile_t *y = &((const kmp_lock_profile_entry_t *)b)->profile;
+  if (x->wait_time != y->wait_time)
+    return x->wait_time > y->wait_time ? -1 : 1;
+  if (x->contended != y->contended)
+    return x->contended > y->contended ? -1 : 1;
+  if (x->acquires != y->acquires)
+    return x->acquires > y->acquires ? -1 : 1;
+  return 0;
+}
+
+// Locks with the same source location are reported as one site, locks without
+// one (e.g., from omp_init_lock) by the address of their lock object, which
+// may have served several locks in turn.
+void __kmp_print_lock_profile(int n) {
+  kmp_lock_profile_entry_t *entries, *e;
+  kmp_lock_index_t i, next;
+  int count = 0, sites = 0;
+
+  if (!__kmp_lock_profile || !__kmp_init_user_locks)
+    return;
+  for (e = __kmp_lock_profile_retired; e != NULL; e = e->next)
+    count++;
+  // Locks allocated meanwhile are left out
+  next = KMP_ATOMIC_LD_ACQ(&__kmp_i_lock_table.next);
+  count += next;
+  entries = (kmp_lock_profile_entry_t *)__kmp_allocate(
+      (count + 1) * sizeof(kmp_lock_profile_entry_t));
+
+  count = 0;
+  for (e = __kmp_lock_profile_retired; e != NULL; e = e->next)
+    entries[count++] = *e;
+  for (i = 0; i < next; ++i) {
+    kmp_indirect_lock_t *l = __kmp_find_indirect_lock(i);
+    if (l == NULL || TCR_PTR(l->lock) == NULL)
+      continue;
+    kmp_lock_profile_t *p = KMP_LOCK_PROFILE(l->lock, l->type);
+    if (p->acquires == 0)
+      continue;
+    entries[count].lock = l->lock;
+    entries[count].profile = *p;
+    count++;
+  }
+
+  // Merge the entries of each source location
+  qsort(entries, count, sizeof(*entries), __kmp_lock_profile_cmp_location);
+  for (int k = 0; k < count; ++k) {
+    kmp_lock_profile_t *p = &entries[k].profile;
+    if (sites > 0 && p->location == entries[sites - 1].profile.location &&
+        (p->location != NULL || entries[k].lock == entries[sites - 1].lock)) {
+      kmp_lock_profile_t *s = &entries[sites - 1].profile;
+      s->acquires += p->acquires;
+      s->contended += p->contended;
+      s->wait_time += p->wait_time;
+      if (p->max_hold > s->max_hold)
+        s->max_hold = p->max_hold;
+      s->switches += p->switches;
+      continue;
+    }
+    entries[sites++] = entries[k];
+  }
+  qsort(entries, sites, sizeof(*entries), __kmp_lock_profile_cmp_wait);
+
+  if (n <= 0 || n > sites)
+    n = sites;
+  __kmp_printf("Lock profile: %d of %d lock sites by wait time\n", n, sites);
+  __kmp_printf("%14s %14s %18s %18s %10s  %s\n", "acquires", "contended",
+               "wait", "max hold", "switches", "location");
+  for (int k = 0; k < n; ++k) {
+    kmp_lock_profile_t *p = &entries[k].profile;
+    char buf[32];
+    if (p->location != NULL && p->location->psource != NULL) {
+      kmp_str_loc_t loc = __kmp_str_loc_init(p->location->psource, 0);
+      __kmp_printf("%14" KMP_UINT64_SPEC " %14" KMP_UINT64_SPEC
+                   " %18" KMP_UINT64_SPEC " %18" KMP_UINT64_SPEC
+                   " %10" KMP_UINT64_SPEC "  %s:%d %s\n",
+                   p->acquires, p->contended, p->wait_time, p->max_hold,
+                   p->switches, loc.file ? loc.file : "?", loc.line,
+                   loc.func ? loc.func : "?");
+      __kmp_str_loc_free(&loc);
+    } else {
+      KMP_SNPRINTF(buf, sizeof(buf), "lock %p", entries[k].lock);
+      __kmp_printf("%14" KMP_UINT64_SPEC " %14" KMP_UINT64_SPEC
+                   " %18" KMP_UINT64_SPEC " %18" KMP_UINT64_SPEC
+                   " %10" KMP_UINT64_SPEC "  %s\n",
+                   p->acquires, p->contended, p->wait_time, p->max_hold,
+                   p->switches, buf);
+    }
+  }
+  __kmp_free(entries);
+}
+
+// Returns the table entry of a new index, installing the directory block and
+// the chunk of its row if they are not there yet. Threads getting other
+// indices of the same block or row race to install them; the losers free
+// theirs.
+static kmp_indirect_lock_t *
+__kmp_new_indirect_lock_index(kmp_lock_index_t *idx) {
+  kmp_lock_index_t i = KMP_ATOMIC_INC(&__kmp_i_lock_table.next);
+  kmp_lock_index_t d = i / KMP_I_LOCK_CHUNK / KMP_I_LOCK_DIR_ROWS;
+  // The index is kept shifted by one bit in the user lock
+  if (d >= KMP_I_LOCK_DIRS || i > (~(kmp_lock_index_t)0 >> 1)) {
+    KMP_FATAL(MemoryAllocFailed);
+  }
+  kmp_indirect_lock_t ***dirp = &__kmp_i_lock_table.dir[d];
+  if (TCR_PTR(*dirp) == NULL) {
+    kmp_indirect_lock_t **dir = (kmp_indirect_lock_t **)__kmp_allocate(
+        KMP_I_LOCK_DIR_ROWS * sizeof(kmp_indirect_lock_t *));
+    if (!KMP_COMPARE_AND_STORE_PTR(dirp, NULL, dir))
+      __kmp_free(dir);
+  }
+  kmp_indirect_lock_t **rowp =
+      &(*dirp)[i / KMP_I_LOCK_CHUNK % KMP_I_LOCK_DIR_ROWS];
+  if (TCR_PTR(*rowp) == NULL) {
+    kmp_indirect_lock_t *chunk = (kmp_indirect_lock_t *)__kmp_allocate(
+        KMP_I_LOCK_CHUNK * sizeof(kmp_indirect_lock_t));
+    if (!KMP_COMPARE_AND_STORE_PTR(rowp, NULL, chunk))
+      __kmp_free(chunk);
+  }
+  *idx = i;
+  return KMP_GET_I_LOCK(i);
+}
+
 // User lock allocator for dynamically dispatched indirect locks. Every entry of
 // the indirect lock table holds the address and type of the allocated indrect
-// lock (kmp_indirect_lock_t), and the size of the table doubles when it is
-// full. A destroyed indirect lock object is returned to the reusable pool of
-// locks, unique to each lock type.
+// lock (kmp_indirect_lock_t). A destroyed indirect lock object is kept in the
+// pool of the destroying thread, one list per lock type, and reused from there
+// or from the shared pools the thread pools spill into.
 kmp_indirect_lock_t *__kmp_allocate_indirect_lock(void **user_lock,
                                                   kmp_int32 gtid,
                                                   kmp_indirect_locktag_t tag) {
-  kmp_indirect_lock_t *lck;
+  kmp_indirect_lock_pool_t *pool = &__kmp_threads[gtid]->th.th_i_lock_pool;
+  kmp_indirect_lock_t *lck = pool->head[tag];
   kmp_lock_index_t idx;
 
-  __kmp_acquire_lock(&__kmp_global_lock, gtid);
+  if (lck != NULL) {
+    pool->head[tag] = (kmp_indirect_lock_t *)lck->lock->pool.next;
+    pool->size--;
+  } else if (TCR_PTR(__kmp_indirect_lock_pool[tag]) != NULL) {
+    __kmp_acquire_lock(&__kmp_global_lock, gtid);
+    lck = __kmp_indirect_lock_pool[tag];
+    if (lck != NULL)
+      __kmp_indirect_lock_pool[tag] =
+          (kmp_indirect_lock_t *)lck->lock->pool.next;
+    __kmp_release_lock(&__kmp_global_lock, gtid);
+  }
 
-  if (__kmp_indirect_lock_pool[tag] != NULL) {
+  if (lck != NULL) {
     // Reuse the allocated and destroyed lock object
-    lck = __kmp_indirect_lock_pool[tag];
     if (OMP_LOCK_T_SIZE < sizeof(void *))
       idx = lck->lock->pool.index;
-    __kmp_indirect_lock_pool[tag] = (kmp_indirect_lock_t *)lck->lock->pool.next;
+    if (__kmp_lock_profile) {
+      __kmp_acquire_lock(&__kmp_global_lock, gtid);
+      __kmp_retire_lock_profile(lck);
+      __kmp_release_lock(&__kmp_global_lock, gtid);
+    }
     KA_TRACE(20, ("__kmp_allocate_indirect_lock: reusing an existing lock %p\n",
                   lck));
   } else {
-    idx = __kmp_i_lock_table.next;
-    // Check capacity and double the size if it is full
-    if (idx == __kmp_i_lock_table.size) {
-      // Double up the space for block pointers
-      int row = __kmp_i_lock_table.size / KMP_I_LOCK_CHUNK;
-      kmp_indirect_lock_t **new_table = (kmp_indirect_lock_t **)__kmp_allocate(
-          2 * row * sizeof(kmp_indirect_lock_t *));
-      KMP_MEMCPY(new_table, __kmp_i_lock_table.table,
-                 row * sizeof(kmp_indirect_lock_t *));
-      kmp_indirect_lock_t **old_table = __kmp_i_lock_table.table;
-      __kmp_i_lock_table.table = new_table;
-      __kmp_free(old_table);
-      // Allocate new objects in the new blocks
-      for (int i = row; i < 2 * row; ++i)
-        *(__kmp_i_lock_table.table + i) = (kmp_indirect_lock_t *)__kmp_allocate(
-            KMP_I_LOCK_CHUNK * sizeof(kmp_indirect_lock_t));
-      __kmp_i_lock_table.size = 2 * idx;
-    }
-    __kmp_i_lock_table.next++;
-    lck = KMP_GET_I_LOCK(idx);
-    // Allocate a new base lock object
-    lck->lock = (kmp_user_lock_p)__kmp_allocate(__kmp_indirect_lock_size[tag]);
+    lck = __kmp_new_indirect_lock_index(&idx);
+    // Allocate a new base lock object, the type goes first for the profile
+    // report walking the table meanwhile
+    lck->type = tag;
+    TCW_PTR(lck->lock,
+            (kmp_user_lock_p)__kmp_allocate(__kmp_indirect_lock_size[tag]));
     KA_TRACE(20,
              ("__kmp_allocate_indirect_lock: allocated a new lock %p\n", lck));
   }
 
-  __kmp_release_lock(&__kmp_global_lock, gtid);
-
   lck->type = tag;
 
   if (OMP_LOCK_T_SIZE < sizeof(void *)) {
@@ -3079,6 +4004,25 @@ kmp_indirect_lock_t *__kmp_allocate_indirect_lock(void **user_lock,
   return lck;
 }
 
+void __kmp_flush_indirect_lock_pool(kmp_indirect_lock_pool_t *pool,
+                                    kmp_int32 gtid) {
+  if (pool->size == 0)
+    return;
+  __kmp_acquire_lock(&__kmp_global_lock, gtid);
+  for (int k = 0; k < KMP_NUM_I_LOCKS; ++k) {
+    kmp_indirect_lock_t *tail = pool->head[k];
+    if (tail == NULL)
+      continue;
+    while (tail->lock->pool.next != NULL)
+      tail = (kmp_indirect_lock_t *)tail->lock->pool.next;
+    tail->lock->pool.next = (kmp_user_lock_p)__kmp_indirect_lock_pool[k];
+    __kmp_indirect_lock_pool[k] = pool->head[k];
+    pool->head[k] = NULL;
+  }
+  pool->size = 0;
+  __kmp_release_lock(&__kmp_global_lock, gtid);
+}
+
 // User lock lookup for dynamically dispatched locks.
 static __forceinline kmp_indirect_lock_t *
 __kmp_lookup_indirect_lock(void **user_lock, const char *func) {
@@ -3089,10 +4033,10 @@ __kmp_lookup_indirect_lock(void **user_lock, const char *func) {
     }
     if (OMP_LOCK_T_SIZE < sizeof(void *)) {
       kmp_lock_index_t idx = KMP_EXTRACT_I_INDEX(user_lock);
-      if (idx >= __kmp_i_lock_table.size) {
+      if (idx >= KMP_ATOMIC_LD_ACQ(&__kmp_i_lock_table.next) ||
+          (lck = __kmp_find_indirect_lock(idx)) == NULL) {
         KMP_FATAL(LockIsUninitialized, func);
       }
-      lck = KMP_GET_I_LOCK(idx);
     } else {
       lck = *((kmp_indirect_lock_t **)user_lock);
     }
@@ -3132,22 +4076,21 @@ static void __kmp_init_indirect_lock(kmp_dyna_lock_t *lock,
 }
 
 static void __kmp_destroy_indirect_lock(kmp_dyna_lock_t *lock) {
-  kmp_uint32 gtid = __kmp_entry_gtid();
+  kmp_int32 gtid = __kmp_entry_gtid();
   kmp_indirect_lock_t *l =
       __kmp_lookup_indirect_lock((void **)lock, "omp_destroy_lock");
   KMP_I_LOCK_FUNC(l, destroy)(l->lock);
   kmp_indirect_locktag_t tag = l->type;
-
-  __kmp_acquire_lock(&__kmp_global_lock, gtid);
+  kmp_indirect_lock_pool_t *pool = &__kmp_threads[gtid]->th.th_i_lock_pool;
 
   // Use the base lock's space to keep the pool chain.
-  l->lock->pool.next = (kmp_user_lock_p)__kmp_indirect_lock_pool[tag];
+  l->lock->pool.next = (kmp_user_lock_p)pool->head[tag];
   if (OMP_LOCK_T_SIZE < sizeof(void *)) {
     l->lock->pool.index = KMP_EXTRACT_I_INDEX(lock);
   }
-  __kmp_indirect_lock_pool[tag] = l;
-
-  __kmp_release_lock(&__kmp_global_lock, gtid);
+  pool->head[tag] = l;
+  if (++pool->size > KMP_I_LOCK_CHUNK)
+    __kmp_flush_indirect_lock_pool(pool, gtid);
 }
 
 static int __kmp_set_indirect_lock(kmp_dyna_lock_t *lock, kmp_int32 gtid) {
@@ -3211,6 +4154,12 @@ kmp_int32 __kmp_get_user_lock_owner(kmp_user_lock_p lck, kmp_uint32 seq) {
   case lockseq_drdpa:
   case lockseq_nested_drdpa:
     return __kmp_get_drdpa_lock_owner((kmp_drdpa_lock_t *)lck);
+  case lockseq_cohort:
+    return ((kmp_cohort_lock_t *)lck)->lk.owner_id - 1;
+  case lockseq_hybrid:
+    return ((kmp_hybrid_lock_t *)lck)->lk.owner_id - 1;
+  case lockseq_rw:
+    return KMP_ATOMIC_LD_RLX(&((kmp_rw_lock_t *)lck)->lk.writer) - 1;
   default:
     return 0;
   }
@@ -3238,18 +4187,32 @@ void __kmp_init_dynamic_user_locks() {
     __kmp_indirect_test = indirect_test;
     __kmp_indirect_destroy = indirect_destroy;
   }
+  if (__kmp_lock_profile) {
+    profiled_set = __kmp_indirect_set;
+    profiled_unset = __kmp_indirect_unset;
+    profiled_test = __kmp_indirect_test;
+#if KMP_USE_TSX
+    // Do not write the profile inside transactions
+    indirect_set_profile[locktag_rtm] = profiled_set[locktag_rtm];
+    indirect_unset_profile[locktag_rtm] = profiled_unset[locktag_rtm];
+    indirect_test_profile[locktag_rtm] = profiled_test[locktag_rtm];
+#endif
+#if KMP_USE_ADAPTIVE_LOCKS
+    indirect_set_profile[locktag_adaptive] = profiled_set[locktag_adaptive];
+    indirect_unset_profile[locktag_adaptive] = profiled_unset[locktag_adaptive];
+    indirect_test_profile[locktag_adaptive] = profiled_test[locktag_adaptive];
+#endif
+    __kmp_indirect_set = indirect_set_profile;
+    __kmp_indirect_unset = indirect_unset_profile;
+    __kmp_indirect_test = indirect_test_profile;
+  }
   // If the user locks have already been initialized, then return. Allow the
   // switch between different KMP_CONSISTENCY_CHECK values, but do not allocate
   // new lock tables if they have already been allocated.
   if (__kmp_init_user_locks)
     return;
 
-  // Initialize lock index table
-  __kmp_i_lock_table.size = KMP_I_LOCK_CHUNK;
-  __kmp_i_lock_table.table =
-      (kmp_indirect_lock_t **)__kmp_allocate(sizeof(kmp_indirect_lock_t *));
-  *(__kmp_i_lock_table.table) = (kmp_indirect_lock_t *)__kmp_allocate(
-      KMP_I_LOCK_CHUNK * sizeof(kmp_indirect_lock_t));
+  // Initialize lock index table, the rows are allocated on demand
   __kmp_i_lock_table.next = 0;
 
   // Indirect lock size
@@ -3259,6 +4222,9 @@ void __kmp_init_dynamic_user_locks() {
   __kmp_indirect_lock_size[locktag_adaptive] = sizeof(kmp_adaptive_lock_t);
 #endif
   __kmp_indirect_lock_size[locktag_drdpa] = sizeof(kmp_drdpa_lock_t);
+  __kmp_indirect_lock_size[locktag_cohort] = sizeof(kmp_cohort_lock_t);
+  __kmp_indirect_lock_size[locktag_hybrid] = sizeof(kmp_hybrid_lock_t);
+  __kmp_indirect_lock_size[locktag_rw] = sizeof(kmp_rw_lock_t);
 #if KMP_USE_TSX
   __kmp_indirect_lock_size[locktag_rtm] = sizeof(kmp_queuing_lock_t);
 #endif
@@ -3270,6 +4236,15 @@ void __kmp_init_dynamic_user_locks() {
   __kmp_indirect_lock_size[locktag_nested_queuing] = sizeof(kmp_queuing_lock_t);
   __kmp_indirect_lock_size[locktag_nested_drdpa] = sizeof(kmp_drdpa_lock_t);
 
+  // Room for the profile behind each base lock object
+  if (__kmp_lock_profile) {
+    for (int k = 0; k < KMP_NUM_I_LOCKS; ++k) {
+      __kmp_lock_profile_offset[k] = (__kmp_indirect_lock_size[k] + 7) & ~7;
+      __kmp_indirect_lock_size[k] =
+          __kmp_lock_profile_offset[k] + sizeof(kmp_lock_profile_t);
+    }
+  }
+
 // Initialize lock accessor/modifier
 #define fill_jumps(table, expand, sep)                                         \
   {                                                                            \
@@ -3296,6 +4271,9 @@ void __kmp_init_dynamic_user_locks() {
 #define expand(l)                                                              \
   (void (*)(kmp_user_lock_p, const ident_t *)) __kmp_set_##l##_lock_location
   fill_table(__kmp_indirect_set_location, expand);
+  __kmp_indirect_set_location[locktag_cohort] = expand(cohort);
+  __kmp_indirect_set_location[locktag_hybrid] = expand(hybrid);
+  __kmp_indirect_set_location[locktag_rw] = expand(rw);
 #undef expand
 #define expand(l)                                                              \
   (void (*)(kmp_user_lock_p, kmp_lock_flags_t)) __kmp_set_##l##_lock_flags
@@ -3304,6 +4282,9 @@ void __kmp_init_dynamic_user_locks() {
 #define expand(l)                                                              \
   (const ident_t *(*)(kmp_user_lock_p)) __kmp_get_##l##_lock_location
   fill_table(__kmp_indirect_get_location, expand);
+  __kmp_indirect_get_location[locktag_cohort] = expand(cohort);
+  __kmp_indirect_get_location[locktag_hybrid] = expand(hybrid);
+  __kmp_indirect_get_location[locktag_rw] = expand(rw);
 #undef expand
 #define expand(l)                                                              \
   (kmp_lock_flags_t(*)(kmp_user_lock_p)) __kmp_get_##l##_lock_flags
@@ -3318,6 +4299,14 @@ void __kmp_cleanup_indirect_user_locks() {
   kmp_lock_index_t i;
   int k;
 
+  if (__kmp_lock_profile > 0)
+    __kmp_print_lock_profile(__kmp_lock_profile);
+  while (__kmp_lock_profile_retired != NULL) {
+    kmp_lock_profile_entry_t *e = __kmp_lock_profile_retired;
+    __kmp_lock_profile_retired = e->next;
+    __kmp_free(e);
+  }
+
   // Clean up locks in the pools first (they were already destroyed before going
   // into the pools).
   for (k = 0; k < KMP_NUM_I_LOCKS; ++k) {
@@ -3334,8 +4323,8 @@ void __kmp_cleanup_indirect_user_locks() {
   }
   // Clean up the remaining undestroyed locks.
   for (i = 0; i < __kmp_i_lock_table.next; i++) {
-    kmp_indirect_lock_t *l = KMP_GET_I_LOCK(i);
-    if (l->lock != NULL) {
+    kmp_indirect_lock_t *l = __kmp_find_indirect_lock(i);
+    if (l != NULL && l->lock != NULL) {
       // Locks not destroyed explicitly need to be destroyed here.
       KMP_I_LOCK_FUNC(l, destroy)(l->lock);
       KA_TRACE(
@@ -3345,10 +4334,26 @@ void __kmp_cleanup_indirect_user_locks() {
       __kmp_free(l->lock);
     }
   }
-  // Free the table
-  for (i = 0; i < __kmp_i_lock_table.size / KMP_I_LOCK_CHUNK; i++)
-    __kmp_free(__kmp_i_lock_table.table[i]);
-  __kmp_free(__kmp_i_lock_table.table);
+  // Free the table; only the directory blocks of the indices handed out can
+  // be in use
+  kmp_lock_index_t num_rows =
+      (__kmp_i_lock_table.next + KMP_I_LOCK_CHUNK - 1) / KMP_I_LOCK_CHUNK;
+  kmp_lock_index_t num_dirs =
+      (num_rows + KMP_I_LOCK_DIR_ROWS - 1) / KMP_I_LOCK_DIR_ROWS;
+  if (num_dirs > KMP_I_LOCK_DIRS)
+    num_dirs = KMP_I_LOCK_DIRS;
+  for (i = 0; i < num_dirs; i++) {
+    kmp_indirect_lock_t **dir = __kmp_i_lock_table.dir[i];
+    if (dir == NULL)
+      continue;
+    for (int r = 0; r < KMP_I_LOCK_DIR_ROWS; r++) {
+      if (dir[r] != NULL)
+        __kmp_free(dir[r]);
+    }
+    __kmp_free(dir);
+    __kmp_i_lock_table.dir[i] = NULL;
+  }
+  __kmp_i_lock_table.next = 0;
 
   __kmp_init_user_locks = FALSE;
 }
@@ -162,6 +162,12 @@ extern void __kmp_destroy_nested_tas_lock(kmp_tas_lock_t *lck);
   (KMP_OS_LINUX && !KMP_OS_CNK &&                                              \
    (KMP_ARCH_X86 || KMP_ARCH_X86_64 || KMP_ARCH_ARM || KMP_ARCH_AARCH64))
 #endif
+
+// With KMP_LOCK_PARK set, waiters of queuing and drdpa locks that have spun
+// for the blocktime sleep on a futex until the releasing thread wakes them.
+#define KMP_USE_LOCK_PARK (KMP_USE_FUTEX && !KMP_USE_MONITOR)
+extern int __kmp_lock_park; // KMP_LOCK_PARK
+
 #if KMP_USE_FUTEX
 
 // ----------------------------------------------------------------------------
@@ -474,6 +480,8 @@ struct kmp_base_drdpa_lock {
   volatile kmp_uint32 owner_id; // (gtid+1) of owning thread, 0 if unlocked
   kmp_int32 depth_locked; // depth locked
   kmp_lock_flags_t flags; // lock specifics, e.g. critical section lock
+  std::atomic<kmp_int32> parked; // waiters sleeping on the polls, read by the
+                                 // owner at release
 };
 
 typedef struct kmp_base_drdpa_lock kmp_base_drdpa_lock_t;
@@ -502,6 +510,128 @@ extern int __kmp_release_nested_drdpa_lock(kmp_drdpa_lock_t *lck,
 extern void __kmp_init_nested_drdpa_lock(kmp_drdpa_lock_t *lck);
 extern void __kmp_destroy_nested_drdpa_lock(kmp_drdpa_lock_t *lck);
 
+#if KMP_USE_DYNAMIC_LOCK
+
+// ----------------------------------------------------------------------------
+// Cohort locks (Dice, Marathe and Shavit, "Lock Cohorting").
+// A thread first takes the queuing lock of its NUMA node, then the global
+// ticket lock. The owner passes the global lock on to the next waiter of its
+// own node, at most __kmp_cohort_handoffs times in a row, so the lock and the
+// data it protects stay on one node while the node has waiters.
+#define KMP_COHORT_NODES 8 // packages beyond this share the local locks
+
+struct KMP_ALIGN_CACHE kmp_cohort_node {
+  kmp_queuing_lock_t local;
+  volatile kmp_uint32 has_global; // global lock passed on inside the node
+  kmp_uint32 handoffs; // passes in a row, only accessed by the local owner
+};
+
+typedef struct kmp_cohort_node kmp_cohort_node_t;
+
+struct kmp_base_cohort_lock {
+  volatile union kmp_cohort_lock *initialized; // points to the lock union
+  ident_t const *location; // Source code location of omp_init_lock().
+  volatile kmp_int32 owner_id; // (gtid+1) of owning thread, 0 if unlocked
+  kmp_int32 owner_node; // local lock held by the owner
+  kmp_ticket_lock_t global;
+  kmp_cohort_node_t nodes[KMP_COHORT_NODES];
+};
+
+typedef struct kmp_base_cohort_lock kmp_base_cohort_lock_t;
+
+union KMP_ALIGN_CACHE kmp_cohort_lock {
+  kmp_base_cohort_lock_t lk;
+  kmp_lock_pool_t pool;
+  double lk_align; // use worst case alignment
+};
+
+typedef union kmp_cohort_lock kmp_cohort_lock_t;
+
+extern int __kmp_cohort_handoffs; // KMP_COHORT_HANDOFFS
+
+// Number of NUMA nodes (packages) the cohort locks know of, 1 if unknown.
+extern int __kmp_cohort_num_nodes(void);
+
+// ----------------------------------------------------------------------------
+// Hybrid locks.
+// A hybrid lock starts as a test and set lock and tracks how many of its
+// acquisitions find other threads using it. Past KMP_HYBRID_UPGRADE it moves
+// to a queuing lock (a cohort lock on machines with several nodes), below
+// KMP_HYBRID_DOWNGRADE back to test and set. Only the owner switches, and only
+// when no other thread is between set and unset, so nobody waits on the old
+// lock; users is biased negative meanwhile to hold off new threads.
+#define KMP_HYBRID_ONE 1024 // contention estimate of a fully contended lock
+#define KMP_HYBRID_UPGRADE (KMP_HYBRID_ONE / 2)
+#define KMP_HYBRID_DOWNGRADE (KMP_HYBRID_ONE / 16)
+#define KMP_HYBRID_DECAY 6 // weight of an acquisition is 1 / 2^KMP_HYBRID_DECAY
+
+struct kmp_base_hybrid_lock {
+  volatile union kmp_hybrid_lock *initialized; // points to the lock union
+  ident_t const *location; // Source code location of omp_init_lock().
+  volatile kmp_int32 owner_id; // (gtid+1) of owning thread, 0 if unlocked
+  volatile kmp_int32 queued; // the queuing (or cohort) lock is in use
+  std::atomic<kmp_int32> users; // threads between set and unset
+  kmp_uint32 contention; // estimate, only accessed by the owner
+  kmp_tas_lock_t tas;
+  kmp_queuing_lock_t queue;
+  kmp_cohort_lock_t *cohort; // used instead of queue if not NULL
+};
+
+typedef struct kmp_base_hybrid_lock kmp_base_hybrid_lock_t;
+
+union KMP_ALIGN_CACHE kmp_hybrid_lock {
+  kmp_base_hybrid_lock_t lk;
+  kmp_lock_pool_t pool;
+  double lk_align; // use worst case alignment
+};
+
+typedef union kmp_hybrid_lock kmp_hybrid_lock_t;
+
+// ----------------------------------------------------------------------------
+// Reader-writer locks (kmpc_*_rw_lock, kmpc_*_rd_lock and kmpc_*_wr_lock).
+// Readers count themselves in one of several cache lines, the one of their
+// NUMA node on machines with several nodes and one picked by gtid otherwise,
+// so readers do not write to a shared line. A writer announces itself in
+// writer and then waits for all counts to drop to zero; readers that find a
+// writer step back until it has left. The set, unset and test entries of the
+// indirect lock tables take the lock for writing.
+#define KMP_RW_LOCK_SLOTS KMP_COHORT_NODES
+
+struct KMP_ALIGN_CACHE kmp_rw_lock_slot {
+  std::atomic<kmp_int32> readers;
+};
+
+typedef struct kmp_rw_lock_slot kmp_rw_lock_slot_t;
+
+struct kmp_base_rw_lock {
+  volatile union kmp_rw_lock *initialized; // points to the lock union
+  ident_t const *location; // Source code location of kmpc_init_rw_lock().
+  std::atomic<kmp_int32> writer; // (gtid+1) of the writer, 0 if none
+  kmp_rw_lock_slot_t slots[KMP_RW_LOCK_SLOTS];
+};
+
+typedef struct kmp_base_rw_lock kmp_base_rw_lock_t;
+
+union KMP_ALIGN_CACHE kmp_rw_lock {
+  kmp_base_rw_lock_t lk;
+  kmp_lock_pool_t pool;
+  double lk_align; // use worst case alignment
+};
+
+typedef union kmp_rw_lock kmp_rw_lock_t;
+
+extern int __kmp_acquire_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid);
+extern int __kmp_test_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid);
+extern int __kmp_release_rw_lock_shared(kmp_rw_lock_t *lck, kmp_int32 gtid);
+extern int __kmp_acquire_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                                    kmp_int32 gtid);
+extern int __kmp_test_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                                 kmp_int32 gtid);
+extern int __kmp_release_rw_lock_shared_with_checks(kmp_rw_lock_t *lck,
+                                                    kmp_int32 gtid);
+
+#endif // KMP_USE_DYNAMIC_LOCK
+
 // ============================================================================
 // Lock purposes.
 // ============================================================================
@@ -593,8 +723,12 @@ enum kmp_lock_kind {
   lk_queuing,
   lk_drdpa,
 #if KMP_USE_ADAPTIVE_LOCKS
-  lk_adaptive
+  lk_adaptive,
 #endif // KMP_USE_ADAPTIVE_LOCKS
+#if KMP_USE_DYNAMIC_LOCK
+  lk_cohort,
+  lk_hybrid
+#endif
 };
 
 typedef enum kmp_lock_kind kmp_lock_kind_t;
@@ -1044,28 +1178,30 @@ extern void __kmp_cleanup_user_locks();
 #define KMP_FOREACH_D_LOCK(m, a) m(tas, a) m(futex, a) m(hle, a)
 #define KMP_FOREACH_I_LOCK(m, a)                                               \
   m(ticket, a) m(queuing, a) m(adaptive, a) m(drdpa, a) m(rtm, a)              \
-      m(nested_tas, a) m(nested_futex, a) m(nested_ticket, a)                  \
-          m(nested_queuing, a) m(nested_drdpa, a)
+      m(cohort, a) m(hybrid, a) m(rw, a) m(nested_tas, a) m(nested_futex, a)   \
+          m(nested_ticket, a) m(nested_queuing, a) m(nested_drdpa, a)
 #else
 #define KMP_FOREACH_D_LOCK(m, a) m(tas, a) m(hle, a)
 #define KMP_FOREACH_I_LOCK(m, a)                                               \
   m(ticket, a) m(queuing, a) m(adaptive, a) m(drdpa, a) m(rtm, a)              \
-      m(nested_tas, a) m(nested_ticket, a) m(nested_queuing, a)                \
-          m(nested_drdpa, a)
+      m(cohort, a) m(hybrid, a) m(rw, a) m(nested_tas, a)                      \
+          m(nested_ticket, a) m(nested_queuing, a) m(nested_drdpa, a)
 #endif // KMP_USE_FUTEX
 #define KMP_LAST_D_LOCK lockseq_hle
 #else
 #if KMP_USE_FUTEX
 #define KMP_FOREACH_D_LOCK(m, a) m(tas, a) m(futex, a)
 #define KMP_FOREACH_I_LOCK(m, a)                                               \
-  m(ticket, a) m(queuing, a) m(drdpa, a) m(nested_tas, a) m(nested_futex, a)   \
-      m(nested_ticket, a) m(nested_queuing, a) m(nested_drdpa, a)
+  m(ticket, a) m(queuing, a) m(drdpa, a) m(cohort, a) m(hybrid, a)             \
+      m(rw, a) m(nested_tas, a) m(nested_futex, a) m(nested_ticket, a)         \
+          m(nested_queuing, a) m(nested_drdpa, a)
 #define KMP_LAST_D_LOCK lockseq_futex
 #else
 #define KMP_FOREACH_D_LOCK(m, a) m(tas, a)
 #define KMP_FOREACH_I_LOCK(m, a)                                               \
-  m(ticket, a) m(queuing, a) m(drdpa, a) m(nested_tas, a) m(nested_ticket, a)  \
-      m(nested_queuing, a) m(nested_drdpa, a)
+  m(ticket, a) m(queuing, a) m(drdpa, a) m(cohort, a) m(hybrid, a)             \
+      m(rw, a) m(nested_tas, a) m(nested_ticket, a) m(nested_queuing, a)       \
+          m(nested_drdpa, a)
 #define KMP_LAST_D_LOCK lockseq_tas
 #endif // KMP_USE_FUTEX
 #endif // KMP_USE_TSX
@@ -1219,20 +1355,44 @@ extern kmp_lock_flags_t (*__kmp_indirect_get_flags[KMP_NUM_I_LOCKS])(
 
 #define KMP_I_LOCK_CHUNK                                                       \
   1024 // number of kmp_indirect_lock_t objects to be allocated together
-
-// Lock table for indirect locks.
+#define KMP_I_LOCK_DIR_ROWS 1024 // chunks listed by one directory block
+#define KMP_I_LOCK_DIRS 2048 // directory blocks, enough for 2^31 indices
+
+// Lock table for indirect locks. Threads take indices with an atomic
+// increment. The chunk of a new row, and the directory block listing it if
+// the row starts a new block, are installed with a compare and store, so
+// allocation does not need a lock and the table only takes memory for the
+// rows in use. Blocks and rows never move once installed, which lets lookups
+// run concurrently with growth.
 typedef struct kmp_indirect_lock_table {
-  kmp_indirect_lock_t **table; // blocks of indirect locks allocated
-  kmp_lock_index_t size; // size of the indirect lock table
-  kmp_lock_index_t next; // index to the next lock to be allocated
+  // directory blocks of KMP_I_LOCK_DIR_ROWS chunks, NULL if unused
+  kmp_indirect_lock_t **dir[KMP_I_LOCK_DIRS];
+  std::atomic<kmp_lock_index_t> next; // index to the next lock to be allocated
 } kmp_indirect_lock_table_t;
 
 extern kmp_indirect_lock_table_t __kmp_i_lock_table;
 
+// Row of the lock table that holds the given index.
+#define KMP_I_LOCK_ROW(index)                                                  \
+  (__kmp_i_lock_table.dir[(index) / KMP_I_LOCK_CHUNK / KMP_I_LOCK_DIR_ROWS]    \
+                         [(index) / KMP_I_LOCK_CHUNK % KMP_I_LOCK_DIR_ROWS])
+
 // Returns the indirect lock associated with the given index.
 #define KMP_GET_I_LOCK(index)                                                  \
-  (*(__kmp_i_lock_table.table + (index) / KMP_I_LOCK_CHUNK) +                  \
-   (index) % KMP_I_LOCK_CHUNK)
+  (KMP_I_LOCK_ROW(index) + (index) % KMP_I_LOCK_CHUNK)
+
+// Destroyed indirect locks kept by a thread for reuse, one list per lock
+// type. Locks destroyed by a thread are reused by the same thread without
+// taking __kmp_global_lock; lists growing past KMP_I_LOCK_CHUNK locks, and
+// the lists of reaped threads, go to the shared pools.
+typedef struct kmp_indirect_lock_pool {
+  kmp_indirect_lock_t *head[KMP_NUM_I_LOCKS];
+  kmp_int32 size; // number of locks in all lists
+} kmp_indirect_lock_pool_t;
+
+// Moves the locks of a thread's pool to the shared pools.
+extern void __kmp_flush_indirect_lock_pool(kmp_indirect_lock_pool_t *pool,
+                                           kmp_int32 gtid);
 
 // Number of locks in a lock block, which is fixed to "1" now.
 // TODO: No lock block implementation now. If we do support, we need to manage
@@ -1244,6 +1404,45 @@ extern int __kmp_num_locks_in_block;
   ((OMP_LOCK_T_SIZE < sizeof(void *)) ? KMP_GET_I_LOCK(KMP_EXTRACT_I_INDEX(l)) \
                                       : *((kmp_indirect_lock_t **)(l)))
 
+// Owner word of nested locks. When omp_nest_lock_t holds the index of the
+// indirect lock in its first half, the second half keeps the owner of the
+// lock and the depth it has been acquired to, so the owner re-acquires and
+// releases the lock with a plain load and store of the word. The indirect
+// nested lock is then held once for all those levels; levels the word cannot
+// count go to the indirect lock and set KMP_NEST_LOCK_SPILLED. The word is 0
+// while no thread owns the lock through it.
+#define KMP_NEST_LOCK_HAS_OWNER_WORD                                           \
+  (OMP_LOCK_T_SIZE < sizeof(void *) &&                                         \
+   OMP_NEST_LOCK_T_SIZE >= 2 * sizeof(kmp_lock_index_t))
+#define KMP_NEST_LOCK_OWNER_WORD(l) ((volatile kmp_uint32 *)(l) + 1)
+#define KMP_NEST_LOCK_DEPTH_MASK 0xFFFF // depth in the low bits
+#define KMP_NEST_LOCK_SPILLED 0x10000 // depth also kept by the indirect lock
+#define KMP_NEST_LOCK_OWNER_SHIFT 17 // gtid+1 of the owner in the high bits
+#define KMP_NEST_LOCK_MAX_OWNER ((1 << (32 - KMP_NEST_LOCK_OWNER_SHIFT)) - 1)
+#define KMP_NEST_LOCK_OWNER(w) ((w) >> KMP_NEST_LOCK_OWNER_SHIFT)
+#define KMP_NEST_LOCK_WORD(gtid, depth)                                        \
+  ((kmp_uint32)((gtid) + 1) << KMP_NEST_LOCK_OWNER_SHIFT | (depth))
+
+// Contention profile of an indirect lock, kept right behind the base lock
+// object when KMP_LOCK_PROFILE is set. The fields are only written by the
+// owner of the lock. Times are in time stamp counter ticks where available,
+// nanoseconds otherwise.
+typedef struct kmp_lock_profile {
+  const ident_t *location; // location of the lock at its first acquisition
+  kmp_uint64 acquires; // all acquisitions, including nested ones
+  kmp_uint64 contended; // acquisitions that had to wait for the lock
+  kmp_uint64 wait_time; // time spent waiting in contended acquisitions
+  kmp_uint64 max_hold; // longest time the lock was held
+  kmp_uint64 hold_start; // time of the current first acquisition
+  kmp_uint64 switches; // hybrid locks: moves between test and set and queuing
+} kmp_lock_profile_t;
+
+// Number of lock sites in the report at exit, 0 if profiling is disabled.
+extern int __kmp_lock_profile; // KMP_LOCK_PROFILE
+
+// Prints the n lock sites with the longest wait times (all if n <= 0).
+extern void __kmp_print_lock_profile(int n);
+
 // Used once in kmp_error.cpp
 extern kmp_int32 __kmp_get_user_lock_owner(kmp_user_lock_p, kmp_uint32);
 
@@ -75,11 +75,15 @@ static void __kmp_initialize_info(kmp_info_t *, kmp_team_t *, int tid,
 static void __kmp_initialize_team(kmp_team_t *team, int new_nproc,
                                   kmp_internal_control_t *new_icvs,
                                   ident_t *loc);
+static void __kmp_reinitialize_team(kmp_team_t *team,
+                                    kmp_internal_control_t *new_icvs,
+                                    ident_t *loc);
 #if KMP_AFFINITY_SUPPORTED
 static void __kmp_partition_places(kmp_team_t *team,
                                    int update_master_only = 0);
 #endif
 static void __kmp_do_serial_initialize(void);
+static void __kmp_prespawn_pool(void);
 void __kmp_fork_barrier(int gtid, int tid);
 void __kmp_join_barrier(int gtid);
 void __kmp_setup_icv_copy(kmp_team_t *team, int new_nproc,
@@ -1018,7 +1022,16 @@ static void __kmp_fork_team_threads(kmp_root_t *root, kmp_team_t *team,
 
     /* now, install the worker threads */
     for (i = 1; i < team->t.t_nproc; i++) {
-
+#if KMP_NESTED_HOT_TEAMS
+      if (team->t.t_threads[i]) {
+        // Parked inner team: the worker is still attached and its barrier
+        // state matches the team, only refresh it for the new master
+        kmp_info_t *thr = team->t.t_threads[i];
+        __kmp_initialize_info(thr, team, i, thr->th.th_info.ds.ds_gtid);
+        thr->th.th_task_state = 0;
+        continue;
+      }
+#endif
       /* fork or reallocate a new thread and install it in team */
       kmp_info_t *thr = __kmp_allocate_thread(root, team, i);
       team->t.t_threads[i] = thr;
@@ -1389,6 +1402,90 @@ void __kmp_serialized_parallel(ident_t *loc, kmp_int32 global_tid) {
 #endif
 }
 
+/* Fast fork path for an outermost parallel region that can reuse the root's
+   hot team exactly as it was left by the previous region: same number of
+   threads, same proc_bind, no dynamic adjustment, no nested or teams
+   constructs.  Thread reservation, team allocation and the forkjoin lock are
+   skipped; only the per-region team fields are published here, the caller
+   copies the arguments and releases the workers from the fork barrier.
+   Returns NULL if the region does not qualify (KMP_FAST_FORK).  */
+static kmp_team_t *__kmp_fork_hot_team_fast(ident_t *loc, int gtid,
+                                            kmp_info_t *master_th,
+                                            kmp_root_t *root,
+                                            kmp_team_t *parent_team,
+                                            kmp_int32 argc, microtask_t microtask,
+                                            launch_t invoker,
+                                            int master_this_cons) {
+  kmp_team_t *team = root->r.r_hot_team;
+  kmp_internal_control_t *icvs = &master_th->th.th_current_task->td_icvs;
+  int nthreads = master_th->th.th_set_nproc ? master_th->th.th_set_nproc
+                                            : icvs->nproc;
+
+  if (!__kmp_fast_fork || root->r.r_active ||
+      parent_team != root->r.r_root_team || master_th->th.th_teams_microtask)
+    return NULL;
+  if (team == NULL || nthreads < 2 || team->t.t_nproc != nthreads ||
+      team->t.t_size_changed != 0 || argc > team->t.t_max_argc)
+    return NULL;
+  // Everything __kmp_reserve_threads() or the ICV setup could change
+  if (icvs->dynamic || icvs->max_active_levels < 1 ||
+      __kmp_library == library_serial || __kmp_nested_nth.used > 1 ||
+      __kmp_nested_proc_bind.used > 1)
+    return NULL;
+  if (master_th->th.th_set_proc_bind != proc_bind_default ||
+      team->t.t_proc_bind != icvs->proc_bind ||
+      icvs->proc_bind == proc_bind_spread)
+    return NULL;
+#if KMP_NESTED_HOT_TEAMS
+  if (master_th->th.th_hot_teams == NULL ||
+      master_th->th.th_hot_teams[0].hot_team != team)
+    return NULL;
+#endif
+  // No task state to push on the memo stack
+  if (__kmp_tasking_mode != tskm_immediate_exec &&
+      master_th->th.th_task_team != NULL)
+    return NULL;
+#if OMPT_SUPPORT
+  if (ompt_enabled.enabled)
+    return NULL;
+#endif
+#if USE_ITT_BUILD
+  // Frame and stack stitching notifications are issued by the regular path
+  if (__itt_frame_begin_v3_ptr || __itt_stack_caller_create_ptr ||
+      KMP_ITT_DEBUG)
+    return NULL;
+#if USE_ITT_NOTIFY
+  if (__itt_frame_submit_v3_ptr)
+    return NULL;
+#endif
+#endif /* USE_ITT_BUILD */
+
+  KA_TRACE(20, ("__kmp_fork_hot_team_fast: T#%d reusing hot team %p\n", gtid,
+                team));
+  master_th->th.th_set_nproc = 0;
+  master_th->th.th_current_task->td_flags.executing = 0;
+  KMP_ATOMIC_INC(&root->r.r_in_parallel);
+
+  // What __kmp_allocate_team() does for an unchanged hot team
+  KMP_CHECK_UPDATE(team->t.t_sched.sched, icvs->sched.sched);
+  __kmp_reinitialize_team(team, icvs, root->r.r_uber_thread->th.th_ident);
+  __kmp_push_current_task_to_thread(team->t.t_threads[0], team, 0);
+  KMP_CHECK_UPDATE(team->t.t_argc, argc);
+
+  KMP_CHECK_UPDATE(team->t.t_master_tid, 0);
+  KMP_CHECK_UPDATE(team->t.t_master_this_cons, master_this_cons);
+  KMP_CHECK_UPDATE(team->t.t_ident, loc);
+  KMP_CHECK_UPDATE(team->t.t_parent, parent_team);
+  KMP_CHECK_UPDATE_SYNC(team->t.t_pkfn, microtask);
+  KMP_CHECK_UPDATE(team->t.t_invoke, invoker);
+  KMP_CHECK_UPDATE(team->t.t_level, 1);
+  KMP_CHECK_UPDATE(team->t.t_active_level, 1);
+  KMP_CHECK_UPDATE(team->t.t_cancel_request, cancel_noreq);
+  KMP_CHECK_UPDATE(team->t.t_def_allocator, master_th->th.th_def_allocator);
+  propagateFPControl(team);
+  return team;
+}
+
 /* most of the work for a fork */
 /* return true if we really went parallel, false if serialized */
 int __kmp_fork_call(ident_t *loc, int gtid,
@@ -1643,6 +1740,45 @@ int __kmp_fork_call(ident_t *loc, int gtid,
       return TRUE;
     } // Parallel closely nested in teams construct
 
+    if (ap && (team = __kmp_fork_hot_team_fast(
+                   loc, gtid, master_th, root, parent_team, argc, microtask,
+                   invoker, master_this_cons)) != NULL) {
+      // The hot team is unchanged: publish the arguments and release the
+      // workers without going through thread reservation and team setup.
+      argv = (void **)team->t.t_argv;
+      for (i = argc - 1; i >= 0; --i) {
+// TODO: revert workaround for Intel(R) 64 tracker #96
+#if (KMP_ARCH_X86_64 || KMP_ARCH_ARM || KMP_ARCH_AARCH64) && KMP_OS_LINUX
+        void *new_argv = va_arg(*ap, void *);
+#else
+        void *new_argv = va_arg(ap, void *);
+#endif
+        KMP_CHECK_UPDATE(*argv, new_argv);
+        argv++;
+      }
+      KMP_CHECK_UPDATE(team->t.t_master_active, master_active);
+      root->r.r_active = TRUE;
+      __kmp_fork_team_threads(root, team, master_th, gtid);
+      __kmp_internal_fork(loc, gtid, team);
+
+      if ((call_context == fork_context_gnu_task_library) |
+          (call_context == fork_context_gnu_task_program)) {
+        KA_TRACE(20, ("__kmp_fork_call: fast parallel exit T#%d\n", gtid));
+        return TRUE;
+      }
+      KA_TRACE(20, ("__kmp_fork_call: T#%d(%d:0) invoke microtask = %p\n", gtid,
+                    team->t.t_id, team->t.t_pkfn));
+      if (!team->t.t_invoke(gtid)) {
+        KMP_ASSERT2(0, "cannot invoke microtask for MASTER thread");
+      }
+      KA_TRACE(20, ("__kmp_fork_call: T#%d(%d:0) done microtask = %p\n", gtid,
+                    team->t.t_id, team->t.t_pkfn));
+      KMP_MB(); /* Flush all pending memory write invalidates.  */
+
+      KA_TRACE(20, ("__kmp_fork_call: fast parallel exit T#%d\n", gtid));
+      return TRUE;
+    }
+
 #if KMP_DEBUG
     if (__kmp_tasking_mode != tskm_immediate_exec) {
       KMP_DEBUG_ASSERT(master_th->th.th_task_team ==
@@ -2547,6 +2683,8 @@ void __kmp_join_call(ident_t *loc, int gtid
 /* Check whether we should push an internal control record onto the
    serial team stack.  If so, do it.  */
 void __kmp_save_internal_controls(kmp_info_t *thread) {
+  // Every ICV setter comes through here before changing the current task
+  KMP_ICVS_CHANGED(thread->th.th_current_task);
 
   if (thread->th.th_team != thread->th.th_serial_team) {
     return;
@@ -3039,6 +3177,8 @@ static void __kmp_free_team_arrays(kmp_team_t *team) {
 #if KMP_USE_HIER_SCHED
   __kmp_dispatch_free_hierarchies(team);
 #endif
+  __kmp_dispatch_free_overflow(team);
+  __kmp_dispatch_free_ordered(team);
   __kmp_free(team->t.t_threads);
   __kmp_free(team->t.t_disp_buffer);
   __kmp_free(team->t.t_dispatch);
@@ -3125,6 +3265,10 @@ static void __kmp_initialize_root(kmp_root_t *root) {
   root->r.r_active = FALSE;
   root->r.r_in_parallel = 0;
   root->r.r_blocktime = __kmp_dflt_blocktime;
+#if KMP_NESTED_HOT_TEAMS
+  root->r.r_nested_teams = NULL;
+  root->r.r_nested_teams_count = 0;
+#endif
 
   /* setup the root team for this task */
   /* allocate the root team structure */
@@ -3815,6 +3959,20 @@ static int __kmp_free_hot_teams(kmp_root_t *root, kmp_info_t *thr, int level,
   __kmp_free_team(root, team, NULL);
   return n;
 }
+
+// Releases the inner teams parked on the root and their threads.
+// Returns the number of threads freed.
+static int __kmp_free_nested_teams(kmp_root_t *root) {
+  int n = 0;
+  while (root->r.r_nested_teams) {
+    kmp_team_t *team = root->r.r_nested_teams;
+    root->r.r_nested_teams = team->t.t_next_pool;
+    n += team->t.t_nproc - 1; // master is not freed
+    __kmp_free_team(root, team, NULL); // no master: not parked again
+  }
+  root->r.r_nested_teams_count = 0;
+  return n;
+}
 #endif
 
 // Resets a root thread and clear its root and hot teams.
@@ -3833,6 +3991,7 @@ static int __kmp_reset_root(int gtid, kmp_root_t *root) {
   // before call to __kmp_free_team().
   __kmp_free_team(root, root_team USE_NESTED_HOT_ARG(NULL));
 #if KMP_NESTED_HOT_TEAMS
+  n += __kmp_free_nested_teams(root);
   if (__kmp_hot_teams_max_level >
       0) { // need to free nested hot teams and their threads if any
     for (i = 0; i < hot_team->t.t_nproc; ++i) {
@@ -4089,6 +4248,7 @@ static void __kmp_initialize_info(kmp_info_t *this_thr, kmp_team_t *team,
                    this_thr->th.th_cg_roots->cg_nthreads));
     this_thr->th.th_current_task->td_icvs.thread_limit =
         this_thr->th.th_cg_roots->cg_thread_limit;
+    KMP_ICVS_CHANGED(this_thr->th.th_current_task);
   }
 
   /* Initialize dynamic dispatch */
@@ -5201,6 +5361,49 @@ __kmp_allocate_team(kmp_root_t *root, int new_nproc, int max_nproc,
     return team;
   }
 
+#if KMP_NESTED_HOT_TEAMS
+  /* next, look for a parked inner team of the same shape */
+  if (master && root->r.r_nested_teams && !master->th.th_teams_microtask &&
+      new_nproc > 1) {
+    kmp_team_t **prev = &root->r.r_nested_teams;
+    for (team = root->r.r_nested_teams; team;
+         prev = &team->t.t_next_pool, team = team->t.t_next_pool) {
+      if (team->t.t_active_level == level + 1 &&
+          team->t.t_nproc == new_nproc && team->t.t_max_nproc >= max_nproc &&
+          team->t.t_proc_bind == new_proc_bind
+#if KMP_AFFINITY_SUPPORTED
+          && team->t.t_first_place == master->th.th_first_place &&
+          team->t.t_last_place == master->th.th_last_place
+#endif
+          )
+        break;
+    }
+    if (team) {
+      *prev = team->t.t_next_pool;
+      root->r.r_nested_teams_count--;
+
+      /* the workers are still attached and parked in the fork barrier, so
+         unlike a pool team the barrier state is kept as is */
+      __kmp_initialize_team(team, new_nproc, new_icvs, NULL);
+      __kmp_alloc_argv_entries(argc, team, TRUE);
+      KMP_CHECK_UPDATE(team->t.t_argc, argc);
+      KMP_DEBUG_ASSERT(team->t.t_task_team[0] == NULL &&
+                       team->t.t_task_team[1] == NULL);
+
+      KA_TRACE(20, ("__kmp_allocate_team: using parked team %d.\n",
+                    team->t.t_id));
+
+#if OMPT_SUPPORT
+      __ompt_team_assign_id(team, ompt_parallel_data);
+#endif
+
+      KMP_MB();
+
+      return team;
+    }
+  }
+#endif // KMP_NESTED_HOT_TEAMS
+
   /* next, let's try to take one from the team pool */
   KMP_MB();
   for (team = CCAST(kmp_team_t *, __kmp_team_pool); (team);) {
@@ -5413,6 +5616,22 @@ void __kmp_free_team(kmp_root_t *root,
       }
     }
 
+#if KMP_NESTED_HOT_TEAMS
+    // Park an inner team with its threads instead of dismantling it
+    if (master && !master->th.th_teams_microtask && team->t.t_nproc > 1 &&
+        root->r.r_nested_teams_count < __kmp_nested_teams_cache) {
+      team->t.t_next_pool = root->r.r_nested_teams;
+      root->r.r_nested_teams = team;
+      root->r.r_nested_teams_count++;
+      KA_TRACE(20, ("__kmp_free_team: T#%d parking team %d (level %d, nproc "
+                    "%d)\n",
+                    __kmp_get_gtid(), team->t.t_id, team->t.t_active_level,
+                    team->t.t_nproc));
+      KMP_MB();
+      return;
+    }
+#endif
+
     // Reset pointer to parent team only for non-hot teams.
     team->t.t_parent = NULL;
     team->t.t_level = 0;
@@ -5450,9 +5669,11 @@ void __kmp_free_team(kmp_root_t *root,
           __kmp_free(tmp); // free CG if we are the last thread in it
         }
         // Restore current task's thread_limit from CG root
-        if (thr->th.th_cg_roots)
+        if (thr->th.th_cg_roots) {
           thr->th.th_current_task->td_icvs.thread_limit =
               thr->th.th_cg_roots->cg_thread_limit;
+          KMP_ICVS_CHANGED(thr->th.th_current_task);
+        }
       }
     }
   }
@@ -5903,6 +6124,15 @@ static void __kmp_reap_thread(kmp_info_t *thread, int is_root) {
     thread->th.th_task_state_memo_stack = NULL;
   }
 
+  if (thread->th.th_atomic_cnode != NULL) {
+    __kmp_free(thread->th.th_atomic_cnode);
+    thread->th.th_atomic_cnode = NULL;
+  }
+
+#if KMP_USE_DYNAMIC_LOCK
+  __kmp_flush_indirect_lock_pool(&thread->th.th_i_lock_pool, gtid);
+#endif
+
 #if KMP_USE_BGET
   if (thread->th.th_local.bget_data != NULL) {
     __kmp_finalize_bget(thread);
@@ -6077,6 +6307,9 @@ void __kmp_internal_end_library(int gtid_req) {
     KA_TRACE(10, ("__kmp_internal_end_library: already finished\n"));
     return;
   }
+#if KMP_OS_UNIX
+  __kmp_join_prespawn_thread();
+#endif
 
   KMP_MB(); /* Flush all pending memory write invalidates.  */
 
@@ -6493,18 +6726,8 @@ static void __kmp_do_serial_initialize(void) {
   __kmp_init_queuing_lock(&__kmp_dispatch_lock);
   __kmp_init_lock(&__kmp_debug_lock);
   __kmp_init_atomic_lock(&__kmp_atomic_lock);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_1i);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_2i);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_4i);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_4r);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_8i);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_8r);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_8c);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_10r);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_16r);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_16c);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_20c);
-  __kmp_init_atomic_lock(&__kmp_atomic_lock_32c);
+  for (i = 0; i < KMP_ATOMIC_LOCKS; ++i)
+    __kmp_init_atomic_lock(&__kmp_atomic_locks[i]);
   __kmp_init_bootstrap_lock(&__kmp_forkjoin_lock);
   __kmp_init_bootstrap_lock(&__kmp_exit_lock);
 #if KMP_USE_MONITOR
@@ -6860,6 +7083,70 @@ void __kmp_middle_initialize(void) {
   __kmp_release_bootstrap_lock(&__kmp_initz_lock);
 }
 
+// -----------------------------------------------------------------------------
+// Eager creation of the thread pool (KMP_PRESPAWN_THREADS)
+
+static void __kmp_prespawn_microtask(kmp_int32 *gtid, kmp_int32 *tid) {}
+
+/* Fork and join an empty region on the calling root so the workers of its hot
+   team are created and bound to their places before the user's first parallel
+   region needs them.  Nothing is done if the thread has requests pending for
+   its next fork (num_threads, proc_bind, teams), which the empty region would
+   consume; the construct they belong to creates the workers anyway. */
+static void __kmp_prespawn_fork(void) {
+  static ident_t loc = {0, KMP_IDENT_KMPC, 0, 0, ";unknown;unknown;0;0;;"};
+  int gtid = __kmp_entry_gtid();
+  kmp_info_t *thr = __kmp_threads[gtid];
+
+  if (!KMP_UBER_GTID(gtid) || thr->th.th_root->r.r_active ||
+      thr->th.th_team->t.t_level != 0)
+    return;
+  if (thr->th.th_set_nproc != 0 ||
+      thr->th.th_set_proc_bind != proc_bind_default ||
+      thr->th.th_teams_microtask != NULL || thr->th.th_teams_size.nteams != 0)
+    return;
+#if OMPT_SUPPORT
+  if (thr->th.ompt_thread_info.return_address != NULL)
+    return;
+#endif
+  KA_TRACE(10, ("__kmp_prespawn_fork: T#%d creating the thread pool\n", gtid));
+  __kmpc_fork_call(&loc, 0, (kmpc_micro)__kmp_prespawn_microtask);
+  KA_TRACE(10, ("__kmp_prespawn_fork: T#%d done\n", gtid));
+}
+
+#if KMP_OS_UNIX
+/* Body of the helper thread: register as a sibling root, run the empty region,
+   then unregister so the workers of the helper's hot team go to the pool. */
+static void *__kmp_prespawn_helper(void *arg) {
+  int gtid = __kmp_entry_gtid();
+  __kmp_prespawn_fork();
+  __kmp_internal_end_thread(gtid);
+  return NULL;
+}
+#endif
+
+/* Called at the end of parallel initialization, which the first construct
+   that needs a team triggers.  Creates the workers right away instead of at
+   the first parallel region when KMP_PRESPAWN_THREADS is set; only the first
+   call does anything.  Middle initialization does not prespawn: it also runs
+   from __kmp_push_num_teams and __kmp_task_alloc, in the middle of a
+   construct. */
+static void __kmp_prespawn_pool(void) {
+  static kmp_int32 started = 0;
+
+  if (!__kmp_prespawn_threads || TCR_4(started) ||
+      !KMP_COMPARE_AND_STORE_ACQ32(&started, 0, 1))
+    return;
+  if (TCR_4(__kmp_global.g.g_done))
+    return;
+#if KMP_OS_UNIX
+  if (__kmp_prespawn_threads == 2 &&
+      __kmp_create_prespawn_thread(__kmp_prespawn_helper))
+    return;
+#endif
+  __kmp_prespawn_fork();
+}
+
 void __kmp_parallel_initialize(void) {
   int gtid = __kmp_entry_gtid(); // this might be a new root
 
@@ -6930,6 +7217,7 @@ void __kmp_parallel_initialize(void) {
   KA_TRACE(10, ("__kmp_parallel_initialize: exit\n"));
 
   __kmp_release_bootstrap_lock(&__kmp_initz_lock);
+  __kmp_prespawn_pool();
 }
 
 /* ------------------------------------------------------------------------ */
@@ -7167,6 +7455,7 @@ void __kmp_push_num_teams(ident_t *id, int gtid, int num_teams,
     // This thread will be the master of the league masters
     // Store new thread limit; old limit is saved in th_cg_roots list
     thr->th.th_current_task->td_icvs.thread_limit = num_threads;
+    KMP_ICVS_CHANGED(thr->th.th_current_task);
 
     if (num_teams * num_threads > __kmp_teams_max_nth) {
       int new_threads = __kmp_teams_max_nth / num_teams;
@@ -7213,10 +7502,12 @@ void __kmp_internal_fork(ident_t *id, int gtid, kmp_team_t *team) {
     for (i = 0; i < __kmp_dispatch_num_buffers; ++i) {
       team->t.t_disp_buffer[i].buffer_index = i;
       team->t.t_disp_buffer[i].doacross_buf_idx = i;
+      team->t.t_disp_buffer[i].ring_claim = 0;
     }
   } else {
     team->t.t_disp_buffer[0].buffer_index = 0;
     team->t.t_disp_buffer[0].doacross_buf_idx = 0;
+    team->t.t_disp_buffer[0].ring_claim = 0;
   }
 
   KMP_MB(); /* Flush all pending memory write invalidates.  */
@@ -7438,6 +7729,11 @@ void __kmp_cleanup(void) {
   __kmp_cleanup_threadprivate_caches();
 
   for (f = 0; f < __kmp_threads_capacity; f++) {
+#if KMP_USE_DYNAMIC_LOCK
+    // Locks destroyed by threads that were not reaped
+    if (__kmp_threads[f] != NULL)
+      __kmp_flush_indirect_lock_pool(&__kmp_threads[f]->th.th_i_lock_pool, f);
+#endif
     if (__kmp_root[f] != NULL) {
       __kmp_free(__kmp_root[f]);
       __kmp_root[f] = NULL;
@@ -7450,11 +7746,14 @@ void __kmp_cleanup(void) {
   __kmp_root = NULL;
   __kmp_threads_capacity = 0;
 
+  __kmp_cleanup_loop_weights();
+
 #if KMP_USE_DYNAMIC_LOCK
   __kmp_cleanup_indirect_user_locks();
 #else
   __kmp_cleanup_user_locks();
 #endif
+  __kmp_cleanup_atomic_combine();
 
 #if KMP_AFFINITY_SUPPORTED
   KMP_INTERNAL_FREE(CCAST(char *, __kmp_cpuinfo_file));
@@ -7999,6 +8298,11 @@ void __kmp_aux_set_blocktime(int arg, kmp_info_t *thread, int tid) {
 
   set__bt_set_team(thread->th.th_team, tid, bt_set);
   set__bt_set_team(thread->th.th_serial_team, 0, bt_set);
+
+  // The current task may be an explicit one, so also make the implicit tasks
+  // owning the slots pull the ICVs again at the next fork.
+  KMP_ICVS_CHANGED(&thread->th.th_team->t.t_implicit_task_taskdata[tid]);
+  KMP_ICVS_CHANGED(&thread->th.th_serial_team->t.t_implicit_task_taskdata[0]);
 #if KMP_USE_MONITOR
   KF_TRACE(10, ("kmp_set_blocktime: T#%d(%d:%d), blocktime=%d, "
                 "bt_intervals=%d, monitor_updates=%d\n",
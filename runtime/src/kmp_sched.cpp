@@ -61,6 +61,302 @@ char const *traits_t<long>::spec = "ld";
 #define KMP_STATS_LOOP_END(stat) /* Nothing */
 #endif
 
+// Cost profiles registered with kmpc_set_loop_weights(). A static loop at the
+// source location of a profile whose trip count matches it is split into
+// contiguous blocks of equal cost instead of equal length. The blocks are
+// computed once per team size and cached with the profile until it is
+// registered again.
+typedef struct kmp_loop_weights_part {
+  struct kmp_loop_weights_part *next;
+  kmp_int32 nproc;
+  kmp_uint64 bound[1]; // nproc + 1 block boundaries
+} kmp_loop_weights_part_t;
+
+typedef struct kmp_loop_weights {
+  struct kmp_loop_weights *next;
+  struct kmp_loop_weights *next_retired;
+  const kmp_uint64 *prefix_sum; // inclusive prefix sums, owned by the user
+  kmp_uint64 n; // trip count the profile describes
+  kmp_loop_weights_part_t *volatile parts; // cached partitions
+  int line; // source line of the loop
+  size_t file_len;
+  char file[1]; // source file of the loop, possibly without its directories
+} kmp_loop_weights_t;
+
+// Loops look profiles up without the lock, counting the lookup in the reader
+// slot of their thread. Profiles that are replaced or removed are unlinked and
+// retired, and only freed by a later registration that finds no lookup in any
+// slot. Each slot has its own cache line, so the lookups of different threads
+// do not write to shared memory.
+#define KMP_LOOP_WEIGHTS_SLOTS 64
+typedef struct KMP_ALIGN_CACHE kmp_loop_weights_readers {
+  std::atomic<kmp_int32> count;
+} kmp_loop_weights_readers_t;
+
+static kmp_loop_weights_t *volatile __kmp_loop_weights = NULL;
+static kmp_loop_weights_t *__kmp_loop_weights_retired = NULL;
+static kmp_loop_weights_readers_t
+    __kmp_loop_weights_readers[KMP_LOOP_WEIGHTS_SLOTS];
+static KMP_BOOTSTRAP_LOCK_INIT(__kmp_loop_weights_lock);
+
+static void __kmp_free_loop_weights_entry(kmp_loop_weights_t *w) {
+  kmp_loop_weights_part_t *part = w->parts;
+  while (part != NULL) {
+    kmp_loop_weights_part_t *next = part->next;
+    KMP_INTERNAL_FREE(part);
+    part = next;
+  }
+  KMP_INTERNAL_FREE(w);
+}
+
+// Number of iterations before the first one of thread t's block: the prefix
+// closest to t/nproc of the total cost.
+static kmp_uint64 __kmp_loop_weights_bound(const kmp_uint64 *ps, kmp_uint64 n,
+                                           kmp_uint64 t, kmp_uint64 nproc) {
+  kmp_uint64 total = ps[n - 1];
+  kmp_uint64 target = total / nproc * t + total % nproc * t / nproc;
+  kmp_uint64 lo = 0, hi = n, prev;
+
+  while (lo < hi) { // first prefix sum not below the target
+    kmp_uint64 mid = lo + (hi - lo) / 2;
+    if (ps[mid] < target)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == n)
+    return n;
+  prev = lo ? ps[lo - 1] : 0;
+  return ps[lo] - target <= target - prev ? lo + 1 : lo;
+}
+
+static kmp_loop_weights_part_t *
+__kmp_loop_weights_partition(kmp_loop_weights_t *w, kmp_int32 nproc) {
+  kmp_loop_weights_part_t *part, *head;
+  kmp_int32 t;
+
+  for (part = w->parts; part != NULL; part = part->next)
+    if (part->nproc == nproc)
+      return part;
+  part = (kmp_loop_weights_part_t *)KMP_INTERNAL_MALLOC(
+      sizeof(kmp_loop_weights_part_t) + nproc * sizeof(kmp_uint64));
+  if (part == NULL)
+    return NULL;
+  part->nproc = nproc;
+  part->bound[0] = 0;
+  for (t = 1; t < nproc; ++t) {
+    kmp_uint64 b = __kmp_loop_weights_bound(w->prefix_sum, w->n, t, nproc);
+    part->bound[t] = KMP_MAX(b, part->bound[t - 1]);
+  }
+  part->bound[nproc] = w->n;
+  do { // threads of the team may race to publish the same partition
+    head = w->parts;
+    for (kmp_loop_weights_part_t *p = head; p != NULL; p = p->next) {
+      if (p->nproc == nproc) {
+        KMP_INTERNAL_FREE(part);
+        return p;
+      }
+    }
+    part->next = head;
+  } while (!KMP_COMPARE_AND_STORE_PTR(&w->parts, head, part));
+  return part;
+}
+
+// Checks whether psource, ";file;func;line;col;;", is the location of the
+// profile: the same line, and a file name that ends with the profile's file
+// at a directory boundary.
+static bool __kmp_loop_weights_site(kmp_loop_weights_t const *w,
+                                    char const *psource) {
+  char const *file, *end, *tail;
+  int line = 0;
+
+  if (psource == NULL || *psource != ';')
+    return false;
+  file = psource + 1;
+  for (end = file; *end != ';' && *end != '\0'; ++end)
+    ;
+  if (*end != ';' || (size_t)(end - file) < w->file_len)
+    return false;
+  tail = end - w->file_len;
+  if (tail > file && tail[-1] != '/' && tail[-1] != '\\')
+    return false;
+  if (strncmp(tail, w->file, w->file_len) != 0)
+    return false;
+  for (++end; *end != ';' && *end != '\0'; ++end) // skip the function
+    ;
+  if (*end != ';' || end[1] < '0' || end[1] > '9')
+    return false;
+  for (++end; *end >= '0' && *end <= '9'; ++end)
+    line = line * 10 + (*end - '0');
+  return line == w->line;
+}
+
+// Finds the block [*begin, *end) of thread tid in the equal-cost partition of
+// the profile for the loop at loc with trip_count iterations, if there is one.
+static bool __kmp_loop_weights_block(ident_t const *loc, kmp_int32 gtid,
+                                     kmp_uint64 trip_count, kmp_int32 nproc,
+                                     kmp_int32 tid, kmp_uint64 *begin,
+                                     kmp_uint64 *end) {
+  std::atomic<kmp_int32> *readers =
+      &__kmp_loop_weights_readers[gtid % KMP_LOOP_WEIGHTS_SLOTS].count;
+  kmp_loop_weights_t *w;
+  kmp_loop_weights_part_t *part = NULL;
+
+  if (loc == NULL)
+    return false;
+  readers->fetch_add(1); // keeps retired profiles alive
+  for (w = __kmp_loop_weights; w != NULL; w = w->next)
+    if (w->n == trip_count && __kmp_loop_weights_site(w, loc->psource))
+      break;
+  if (w != NULL && (part = __kmp_loop_weights_partition(w, nproc)) != NULL) {
+    *begin = part->bound[tid];
+    *end = part->bound[tid + 1];
+  }
+  readers->fetch_sub(1);
+  return part != NULL;
+}
+
+void __kmp_cleanup_loop_weights(void) {
+  kmp_loop_weights_t *w = __kmp_loop_weights;
+  __kmp_loop_weights = NULL;
+  while (w != NULL) {
+    kmp_loop_weights_t *next = w->next;
+    __kmp_free_loop_weights_entry(w);
+    w = next;
+  }
+  w = __kmp_loop_weights_retired;
+  __kmp_loop_weights_retired = NULL;
+  while (w != NULL) {
+    kmp_loop_weights_t *next = w->next_retired;
+    __kmp_free_loop_weights_entry(w);
+    w = next;
+  }
+}
+
+// Static schedules divide the trip count by the team size on every loop entry.
+// The quotient is computed with a multiply and shifts instead (Granlund and
+// Montgomery, "Division by invariant integers using multiplication"): for
+// 2 <= d < 2^24, l = ceil(log2(d)) and m = 2^32 * (2^l - d) / d + 1,
+// n / d == (t + ((n - t) >> 1)) >> (l - 1) with t = (m * n) >> 32 for any
+// 32-bit n. The team caches m, l and d in one word, so the word is rebuilt
+// whenever it was computed for a different team size. 32-bit targets keep
+// the hardware division since they cannot read the word atomically.
+#define KMP_NPROC_DIV_MAX (1 << 24)
+
+static inline kmp_uint64 __kmp_nproc_div_magic(kmp_team_t *team,
+                                               kmp_uint32 nth) {
+  kmp_uint64 magic = team->t.t_nproc_div;
+  if ((kmp_uint32)(magic & (KMP_NPROC_DIV_MAX - 1)) != nth) {
+    kmp_uint32 l = 0;
+    while (((kmp_uint64)1 << l) < nth)
+      ++l;
+    kmp_uint64 m = ((((kmp_uint64)1 << l) - nth) << 32) / nth + 1;
+    magic = (m << 32) | ((kmp_uint64)l << 24) | nth;
+    team->t.t_nproc_div = magic; // racing threads store the same value
+  }
+  return magic;
+}
+
+template <typename UT>
+static inline void __kmp_nproc_divmod(kmp_team_t *team, kmp_uint32 nth, UT n,
+                                      UT *quot, UT *rem) {
+  KMP_DEBUG_ASSERT(nth > 1);
+#if !KMP_32_BIT_ARCH
+  if ((kmp_uint64)n <= 0xFFFFFFFFu && nth < KMP_NPROC_DIV_MAX) {
+    kmp_uint64 magic = __kmp_nproc_div_magic(team, nth);
+    kmp_uint32 n32 = (kmp_uint32)n;
+    kmp_uint32 t = (kmp_uint32)(((magic >> 32) * n32) >> 32);
+    kmp_uint32 q = (t + ((n32 - t) >> 1)) >> (((magic >> 24) & 0xFF) - 1);
+    KMP_DEBUG_ASSERT(q == n32 / nth);
+    *quot = (UT)q;
+    *rem = (UT)(n32 - q * nth);
+    return;
+  }
+#endif
+  *quot = n / nth;
+  *rem = n % nth;
+}
+
+// Block of iterations [*begin, *end) of member id among n for an unchunked
+// static schedule of trip iterations, without overflowing near the top of the
+// iteration type.
+template <typename UT>
+static inline void __kmp_static_block(kmp_team_t *team, kmp_uint32 n,
+                                      kmp_uint32 id, UT trip, UT *begin,
+                                      UT *end) {
+  UT quot, rem;
+  if (n == 1) {
+    *begin = 0;
+    *end = trip;
+    return;
+  }
+  __kmp_nproc_divmod<UT>(team, n, trip, &quot, &rem);
+  if (__kmp_static == kmp_sch_static_balanced) {
+    *begin = id * quot + (id < rem ? id : rem);
+    *end = *begin + quot + (id < rem ? 1 : 0);
+  } else {
+    KMP_DEBUG_ASSERT(__kmp_static == kmp_sch_static_greedy);
+    UT room = trip - id * quot; // blocks are quot + 1 long if rem != 0
+    *begin = id * quot + (rem == 0 ? 0 : id < room ? id : room);
+    room = trip - *begin;
+    quot += rem ? 1 : 0;
+    *end = *begin + (quot < room ? quot : room);
+  }
+}
+
+// Common case of a "for" loop with schedule(static), unit increment and no
+// chunk in an active team: skips the checks the generic path makes for
+// distribute, serialized teams, other schedules and tools. Returns false
+// when the generic path has to handle the loop.
+template <typename T>
+static __forceinline bool
+__kmp_for_static_init_unit(kmp_int32 gtid, kmp_int32 *plastiter, T *plower,
+                           T *pupper, typename traits_t<T>::signed_t *pstride) {
+  typedef typename traits_t<T>::unsigned_t UT;
+  // statistics builds count every loop in the generic path
+  if (KMP_STATS_ENABLED || __kmp_env_consistency_check ||
+      __kmp_loop_weights != NULL || *pupper < *plower)
+    return false;
+#if OMPT_SUPPORT && OMPT_OPTIONAL
+  if (ompt_enabled.ompt_callback_work)
+    return false;
+#endif
+#if USE_ITT_BUILD
+  if (__itt_metadata_add_ptr && __kmp_forkjoin_frames_mode == 3)
+    return false;
+#endif
+  kmp_info_t *th = __kmp_threads[gtid];
+  kmp_team_t *team = th->th.th_team;
+  kmp_uint32 nth = team->t.t_nproc;
+  UT trip_count = (UT)(*pupper - *plower) + 1;
+  if (team->t.t_serialized || nth == 1 || trip_count < nth)
+    return false;
+
+  kmp_uint32 tid = th->th.th_info.ds.ds_tid;
+  UT chunk, extras;
+  __kmp_nproc_divmod<UT>(team, nth, trip_count, &chunk, &extras);
+  if (__kmp_static == kmp_sch_static_balanced) {
+    *plower += (T)(tid * chunk + (tid < extras ? tid : extras));
+    *pupper = *plower + (T)chunk - (tid < extras ? 0 : 1);
+    if (plastiter != NULL)
+      *plastiter = (tid == nth - 1);
+  } else {
+    T old_upper = *pupper;
+    chunk += extras ? 1 : 0;
+    *plower += (T)(tid * chunk);
+    *pupper = *plower + (T)chunk - 1;
+    if (*pupper < *plower)
+      *pupper = traits_t<T>::max_value;
+    if (plastiter != NULL)
+      *plastiter = *plower <= old_upper && *pupper > old_upper - 1;
+    if (*pupper > old_upper)
+      *pupper = old_upper;
+  }
+  *pstride = trip_count;
+  KE_TRACE(10, ("__kmpc_for_static_init: T#%d unit-stride return\n", gtid));
+  return true;
+}
+
 template <typename T>
 static void __kmp_for_static_init(ident_t *loc, kmp_int32 global_tid,
                                   kmp_int32 schedtype, kmp_int32 *plastiter,
@@ -286,6 +582,7 @@ static void __kmp_for_static_init(ident_t *loc, kmp_int32 global_tid,
   /* compute remaining parameters */
   switch (schedtype) {
   case kmp_sch_static: {
+    kmp_uint64 begin, end;
     if (trip_count < nth) {
       KMP_DEBUG_ASSERT(
           __kmp_static == kmp_sch_static_greedy ||
@@ -298,17 +595,30 @@ static void __kmp_for_static_init(ident_t *loc, kmp_int32 global_tid,
       }
       if (plastiter != NULL)
         *plastiter = (tid == trip_count - 1);
+    } else if (__kmp_loop_weights != NULL && team == th->th.th_team &&
+               __kmp_loop_weights_block(loc, gtid, trip_count, nth, tid, &begin,
+                                        &end)) {
+      // equal-cost blocks from the user's cost profile
+      if (begin < end) {
+        *pupper = *plower + (T)(end - 1) * incr;
+        *plower += (T)begin * incr;
+      } else {
+        *plower = *pupper + incr;
+      }
+      if (plastiter != NULL)
+        *plastiter = (begin < end && end == trip_count);
     } else {
       if (__kmp_static == kmp_sch_static_balanced) {
-        UT small_chunk = trip_count / nth;
-        UT extras = trip_count % nth;
+        UT small_chunk, extras;
+        __kmp_nproc_divmod<UT>(team, nth, trip_count, &small_chunk, &extras);
         *plower += incr * (tid * small_chunk + (tid < extras ? tid : extras));
         *pupper = *plower + small_chunk * incr - (tid < extras ? 0 : incr);
         if (plastiter != NULL)
           *plastiter = (tid == nth - 1);
       } else {
-        T big_chunk_inc_count =
-            (trip_count / nth + ((trip_count % nth) ? 1 : 0)) * incr;
+        UT small_chunk, extras;
+        __kmp_nproc_divmod<UT>(team, nth, trip_count, &small_chunk, &extras);
+        T big_chunk_inc_count = (small_chunk + (extras ? 1 : 0)) * incr;
         T old_upper = *pupper;
 
         KMP_DEBUG_ASSERT(__kmp_static == kmp_sch_static_greedy);
@@ -416,6 +726,100 @@ static void __kmp_for_static_init(ident_t *loc, kmp_int32 global_tid,
   return;
 }
 
+// Moves boundary b between two teams of a unit-stride loop to the nearest
+// iteration whose loop variable value starts a page of per elements.
+template <typename T>
+static typename traits_t<T>::unsigned_t
+__kmp_dist_align_bound(T lower, typename traits_t<T>::signed_t incr,
+                       typename traits_t<T>::unsigned_t b,
+                       typename traits_t<T>::unsigned_t trip,
+                       typename traits_t<T>::unsigned_t per) {
+  typedef typename traits_t<T>::unsigned_t UT;
+  if (b == 0 || b == trip)
+    return b;
+  // value of the first element of the page the boundary has to start
+  UT edge = incr > 0 ? (UT)lower + b : (UT)lower + 1 - b;
+  UT r = edge & (per - 1);
+  if (r == 0)
+    return b;
+  UT fwd = incr > 0 ? per - r : r; // b + fwd is aligned
+  UT back = per - fwd; // and so is b - back
+  if (back <= fwd)
+    return back < b ? b - back : 0;
+  return fwd < trip - b ? b + fwd : trip;
+}
+
+// Unchunked distribute parallel loop: computes the team's block and the
+// thread's block inside it in one pass over iteration numbers. With an
+// element size hint (KMP_DIST_ELEMENT_SIZE or kmpc_set_dist_element_size())
+// the boundaries between the teams of a unit-stride loop are moved to page
+// boundaries of the data indexed by the loop variable, so that no page is
+// shared by two teams and first touch places each page with its team.
+template <typename T>
+static void __kmp_dist_static_bounds(kmp_info_t *th, kmp_uint32 nteams,
+                                     kmp_uint32 team_id, kmp_uint32 nth,
+                                     kmp_uint32 tid, kmp_int32 *plastiter,
+                                     T *plower, T *pupper, T *pupperDist,
+                                     typename traits_t<T>::signed_t incr) {
+  typedef typename traits_t<T>::unsigned_t UT;
+  kmp_team_t *team = th->th.th_team;
+  T lower = *plower;
+  UT trip_count, team_begin, team_end, begin, end;
+
+  if (incr > 0 ? (*pupper < *plower) : (*plower < *pupper)) {
+    *pupperDist = *pupper; // zero-trip loop
+    if (plastiter != NULL)
+      *plastiter = FALSE;
+    return;
+  }
+  if (incr == 1) {
+    trip_count = *pupper - *plower + 1;
+  } else if (incr == -1) {
+    trip_count = *plower - *pupper + 1;
+  } else if (incr > 0) {
+    trip_count = (UT)(*pupper - *plower) / incr + 1;
+  } else {
+    trip_count = (UT)(*plower - *pupper) / (-incr) + 1;
+  }
+
+  // the league is the parent team, so its division constant is for nteams
+  __kmp_static_block<UT>(team->t.t_parent, nteams, team_id, trip_count,
+                         &team_begin, &team_end);
+  if (__kmp_dist_elem_size > 0 && (incr == 1 || incr == -1) && nteams > 1) {
+    size_t page = KMP_GET_PAGE_SIZE();
+    size_t elem = (size_t)__kmp_dist_elem_size;
+    UT per = (UT)(page / elem);
+    // only whole pages of power-of-two sized elements, and only when each
+    // team gets at least a page
+    if (page % elem == 0 && per > 1 &&
+        trip_count / nteams >= per) {
+      team_begin =
+          __kmp_dist_align_bound<T>(lower, incr, team_begin, trip_count, per);
+      team_end =
+          __kmp_dist_align_bound<T>(lower, incr, team_end, trip_count, per);
+    }
+  }
+  if (team_begin >= team_end) {
+    *pupperDist = *pupper; // no iterations available for the team
+    *plower = *pupper + incr;
+    if (plastiter != NULL)
+      *plastiter = FALSE;
+    return;
+  }
+  *pupperDist = lower + (T)(team_end - 1) * incr;
+
+  __kmp_static_block<UT>(team, nth, tid, team_end - team_begin, &begin, &end);
+  if (begin < end) {
+    *plower = lower + (T)(team_begin + begin) * incr;
+    *pupper = lower + (T)(team_begin + end - 1) * incr;
+  } else {
+    *pupper = *pupperDist; // no iterations available for the thread
+    *plower = *pupper + incr;
+  }
+  if (plastiter != NULL)
+    *plastiter = begin < end && team_begin + end == trip_count;
+}
+
 template <typename T>
 static void __kmp_dist_for_static_init(ident_t *loc, kmp_int32 gtid,
                                        kmp_int32 schedule, kmp_int32 *plastiter,
@@ -481,6 +885,13 @@ static void __kmp_dist_for_static_init(ident_t *loc, kmp_int32 gtid,
   team_id = team->t.t_master_tid;
   KMP_DEBUG_ASSERT(nteams == (kmp_uint32)team->t.t_parent->t.t_nproc);
 
+  *pstride = *pupper - *plower; // just in case (can be unused)
+  if (schedule == kmp_sch_static) {
+    __kmp_dist_static_bounds<T>(th, nteams, team_id, nth, tid, plastiter,
+                                plower, pupper, pupperDist, incr);
+    goto end;
+  }
+
   // compute global trip count
   if (incr == 1) {
     trip_count = *pupper - *plower + 1;
@@ -492,8 +903,6 @@ static void __kmp_dist_for_static_init(ident_t *loc, kmp_int32 gtid,
   } else {
     trip_count = (UT)(*plower - *pupper) / (-incr) + 1;
   }
-
-  *pstride = *pupper - *plower; // just in case (can be unused)
   if (trip_count <= nteams) {
     KMP_DEBUG_ASSERT(
         __kmp_static == kmp_sch_static_greedy ||
@@ -566,59 +975,6 @@ static void __kmp_dist_for_static_init(ident_t *loc, kmp_int32 gtid,
     }
     KMP_DEBUG_ASSERT(trip_count);
     switch (schedule) {
-    case kmp_sch_static: {
-      if (trip_count <= nth) {
-        KMP_DEBUG_ASSERT(
-            __kmp_static == kmp_sch_static_greedy ||
-            __kmp_static ==
-                kmp_sch_static_balanced); // Unknown static scheduling type.
-        if (tid < trip_count)
-          *pupper = *plower = *plower + tid * incr;
-        else
-          *plower = *pupper + incr; // no iterations available
-        if (plastiter != NULL)
-          if (*plastiter != 0 && !(tid == trip_count - 1))
-            *plastiter = 0;
-      } else {
-        if (__kmp_static == kmp_sch_static_balanced) {
-          UT chunkL = trip_count / nth;
-          UT extras = trip_count % nth;
-          *plower += incr * (tid * chunkL + (tid < extras ? tid : extras));
-          *pupper = *plower + chunkL * incr - (tid < extras ? 0 : incr);
-          if (plastiter != NULL)
-            if (*plastiter != 0 && !(tid == nth - 1))
-              *plastiter = 0;
-        } else {
-          T chunk_inc_count =
-              (trip_count / nth + ((trip_count % nth) ? 1 : 0)) * incr;
-          T upper = *pupperDist;
-          KMP_DEBUG_ASSERT(__kmp_static == kmp_sch_static_greedy);
-          // Unknown static scheduling type.
-          *plower += tid * chunk_inc_count;
-          *pupper = *plower + chunk_inc_count - incr;
-          if (incr > 0) {
-            if (*pupper < *plower)
-              *pupper = traits_t<T>::max_value;
-            if (plastiter != NULL)
-              if (*plastiter != 0 &&
-                  !(*plower <= upper && *pupper > upper - incr))
-                *plastiter = 0;
-            if (*pupper > upper)
-              *pupper = upper; // tracker C73258
-          } else {
-            if (*pupper > *plower)
-              *pupper = traits_t<T>::min_value;
-            if (plastiter != NULL)
-              if (*plastiter != 0 &&
-                  !(*plower >= upper && *pupper < upper - incr))
-                *plastiter = 0;
-            if (*pupper < upper)
-              *pupper = upper; // tracker C73258
-          }
-        }
-      }
-      break;
-    }
     case kmp_sch_static_chunked: {
       ST span;
       if (chunk < 1)
@@ -795,6 +1151,10 @@ void __kmpc_for_static_init_4(ident_t *loc, kmp_int32 gtid, kmp_int32 schedtype,
                               kmp_int32 *plastiter, kmp_int32 *plower,
                               kmp_int32 *pupper, kmp_int32 *pstride,
                               kmp_int32 incr, kmp_int32 chunk) {
+  if (schedtype == kmp_sch_static && incr == 1 &&
+      __kmp_for_static_init_unit<kmp_int32>(gtid, plastiter, plower, pupper,
+                                     pstride))
+    return;
   __kmp_for_static_init<kmp_int32>(loc, gtid, schedtype, plastiter, plower,
                                    pupper, pstride, incr, chunk
 #if OMPT_SUPPORT && OMPT_OPTIONAL
@@ -812,6 +1172,10 @@ void __kmpc_for_static_init_4u(ident_t *loc, kmp_int32 gtid,
                                kmp_uint32 *plower, kmp_uint32 *pupper,
                                kmp_int32 *pstride, kmp_int32 incr,
                                kmp_int32 chunk) {
+  if (schedtype == kmp_sch_static && incr == 1 &&
+      __kmp_for_static_init_unit<kmp_uint32>(gtid, plastiter, plower, pupper,
+                                     pstride))
+    return;
   __kmp_for_static_init<kmp_uint32>(loc, gtid, schedtype, plastiter, plower,
                                     pupper, pstride, incr, chunk
 #if OMPT_SUPPORT && OMPT_OPTIONAL
@@ -828,6 +1192,10 @@ void __kmpc_for_static_init_8(ident_t *loc, kmp_int32 gtid, kmp_int32 schedtype,
                               kmp_int32 *plastiter, kmp_int64 *plower,
                               kmp_int64 *pupper, kmp_int64 *pstride,
                               kmp_int64 incr, kmp_int64 chunk) {
+  if (schedtype == kmp_sch_static && incr == 1 &&
+      __kmp_for_static_init_unit<kmp_int64>(gtid, plastiter, plower, pupper,
+                                     pstride))
+    return;
   __kmp_for_static_init<kmp_int64>(loc, gtid, schedtype, plastiter, plower,
                                    pupper, pstride, incr, chunk
 #if OMPT_SUPPORT && OMPT_OPTIONAL
@@ -845,6 +1213,10 @@ void __kmpc_for_static_init_8u(ident_t *loc, kmp_int32 gtid,
                                kmp_uint64 *plower, kmp_uint64 *pupper,
                                kmp_int64 *pstride, kmp_int64 incr,
                                kmp_int64 chunk) {
+  if (schedtype == kmp_sch_static && incr == 1 &&
+      __kmp_for_static_init_unit<kmp_uint64>(gtid, plastiter, plower, pupper,
+                                     pstride))
+    return;
   __kmp_for_static_init<kmp_uint64>(loc, gtid, schedtype, plastiter, plower,
                                     pupper, pstride, incr, chunk
 #if OMPT_SUPPORT && OMPT_OPTIONAL
@@ -1001,4 +1373,99 @@ void __kmpc_team_static_init_8u(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
 @}
 */
 
+/*!
+@param loop  Source location of the loop, as "file:line"
+@param prefix_sum  Inclusive prefix sums of the iteration costs
+@param n  Number of iterations described by prefix_sum
+
+Register the cost profile of the loop at @p loop. When that loop is an
+unchunked static loop with exactly @p n iterations, it is split into
+contiguous blocks of about equal cost instead of equal length. The file may be
+given without its leading directories. Only @p prefix_sum[n-1] and the sums
+before it are read; the array is not copied and must stay valid while loops
+may use the profile. Calling this again for the same loop (also after
+modifying the array) replaces the profile and drops its cached partitions; a
+NULL @p prefix_sum removes it. Loops running meanwhile use either profile.
+*/
+void kmpc_set_loop_weights(char const *loop, const kmp_uint64 *prefix_sum,
+                           size_t n) {
+  kmp_loop_weights_t *w = NULL, *old, **prev, *retired = NULL;
+  char const *colon = NULL, *c;
+  size_t file_len;
+  int line = 0, i;
+
+  if (loop == NULL || n == 0)
+    return;
+  for (c = loop; *c != '\0'; ++c)
+    if (*c == ':')
+      colon = c;
+  if (colon == NULL || colon == loop || colon[1] == '\0')
+    return;
+  for (c = colon + 1; *c >= '0' && *c <= '9'; ++c)
+    line = line * 10 + (*c - '0');
+  if (*c != '\0')
+    return;
+  file_len = colon - loop;
+  if (prefix_sum != NULL && prefix_sum[n - 1] > 0) {
+    w = (kmp_loop_weights_t *)KMP_INTERNAL_MALLOC(sizeof(kmp_loop_weights_t) +
+                                                  file_len);
+    if (w == NULL)
+      return;
+    w->prefix_sum = prefix_sum;
+    w->n = n;
+    w->parts = NULL;
+    w->line = line;
+    w->file_len = file_len;
+    KMP_MEMCPY(w->file, loop, file_len);
+    w->file[file_len] = '\0';
+  }
+  __kmp_acquire_bootstrap_lock(&__kmp_loop_weights_lock);
+  for (prev = CCAST(kmp_loop_weights_t **, &__kmp_loop_weights);
+       (old = *prev) != NULL; prev = &old->next) {
+    if (old->line == line && old->file_len == file_len &&
+        strncmp(old->file, loop, file_len) == 0) {
+      *prev = old->next; // old->next stays valid for loops still reading old
+      old->next_retired = __kmp_loop_weights_retired;
+      __kmp_loop_weights_retired = old;
+      break;
+    }
+  }
+  if (w != NULL) {
+    w->next = __kmp_loop_weights;
+    KMP_MB();
+    __kmp_loop_weights = w;
+  }
+  // A loop that starts its lookup from now on cannot find a retired profile,
+  // and one that started earlier is counted in its slot until it is done
+  KMP_MB();
+  for (i = 0; i < KMP_LOOP_WEIGHTS_SLOTS; ++i)
+    if (__kmp_loop_weights_readers[i].count.load() != 0)
+      break;
+  if (i == KMP_LOOP_WEIGHTS_SLOTS) {
+    retired = __kmp_loop_weights_retired;
+    __kmp_loop_weights_retired = NULL;
+  }
+  __kmp_release_bootstrap_lock(&__kmp_loop_weights_lock);
+  KA_TRACE(20, ("kmpc_set_loop_weights: %s n %llu %s\n", loop,
+                (unsigned long long)n, w != NULL ? "set" : "removed"));
+  while (retired != NULL) {
+    old = retired->next_retired;
+    __kmp_free_loop_weights_entry(retired);
+    retired = old;
+  }
+}
+
+/*!
+@param size  Size in bytes of the data each loop iteration writes, or 0
+
+Hint for unchunked distribute parallel loops with unit stride: the boundaries
+between the teams' blocks of iterations are moved to page boundaries of data
+indexed by the loop variable, so that teams placed on different sockets never
+share a page. Only sizes that divide the page size take effect; 0 turns the
+alignment off. Same as setting KMP_DIST_ELEMENT_SIZE.
+*/
+void kmpc_set_dist_element_size(size_t size) {
+  __kmp_dist_elem_size = size > INT_MAX ? 0 : (int)size;
+}
+
 } // extern "C"
@@ -1334,6 +1334,98 @@ static void __kmp_stg_print_disp_buffers(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_dispatch_num_buffers);
 } // __kmp_stg_print_disp_buffers
 
+// -----------------------------------------------------------------------------
+// KMP_DISP_ELASTIC
+
+static void __kmp_stg_parse_disp_elastic(char const *name, char const *value,
+                                         void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_dispatch_elastic);
+} // __kmp_stg_parse_disp_elastic
+
+static void __kmp_stg_print_disp_elastic(kmp_str_buf_t *buffer,
+                                         char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_dispatch_elastic);
+} // __kmp_stg_print_disp_elastic
+
+// -----------------------------------------------------------------------------
+// KMP_STEAL_PAIR
+
+static void __kmp_stg_parse_steal_pair(char const *name, char const *value,
+                                       void *data) {
+  if (__kmp_str_match("auto", 1, value)) {
+    __kmp_steal_pair = 0;
+  } else if (__kmp_str_match("dcas", 1, value)) {
+    __kmp_steal_pair = 1;
+  } else if (__kmp_str_match("lock", 1, value)) {
+    __kmp_steal_pair = 2;
+  } else {
+    KMP_WARNING(StgInvalidValue, name, value);
+  }
+} // __kmp_stg_parse_steal_pair
+
+static void __kmp_stg_print_steal_pair(kmp_str_buf_t *buffer, char const *name,
+                                       void *data) {
+  const char *value = "auto";
+  if (__kmp_steal_pair == 2)
+    value = "lock";
+  else if (__kmp_steal_pair)
+    value = "dcas";
+  __kmp_stg_print_str(buffer, name, value);
+} // __kmp_stg_print_steal_pair
+
+// -----------------------------------------------------------------------------
+// KMP_DOACROSS_WINDOW
+
+static void __kmp_stg_parse_doacross_window(char const *name,
+                                            char const *value, void *data) {
+  __kmp_stg_parse_int(name, value, 0, INT_MAX, &__kmp_doacross_window);
+} // __kmp_stg_parse_doacross_window
+
+static void __kmp_stg_print_doacross_window(kmp_str_buf_t *buffer,
+                                            char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_doacross_window);
+} // __kmp_stg_print_doacross_window
+
+// -----------------------------------------------------------------------------
+// KMP_DIST_ELEMENT_SIZE
+
+static void __kmp_stg_parse_dist_elem_size(char const *name, char const *value,
+                                           void *data) {
+  __kmp_stg_parse_int(name, value, 0, INT_MAX, &__kmp_dist_elem_size);
+} // __kmp_stg_parse_dist_elem_size
+
+static void __kmp_stg_print_dist_elem_size(kmp_str_buf_t *buffer,
+                                           char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_dist_elem_size);
+} // __kmp_stg_print_dist_elem_size
+
+// -----------------------------------------------------------------------------
+// KMP_ADAPTIVE_AUTO
+
+static void __kmp_stg_parse_adaptive_auto(char const *name, char const *value,
+                                          void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_adaptive_auto);
+} // __kmp_stg_parse_adaptive_auto
+
+static void __kmp_stg_print_adaptive_auto(kmp_str_buf_t *buffer,
+                                          char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_adaptive_auto);
+} // __kmp_stg_print_adaptive_auto
+
+// -----------------------------------------------------------------------------
+// KMP_DISP_CHUNK_BATCH
+
+static void __kmp_stg_parse_disp_chunk_batch(char const *name,
+                                             char const *value, void *data) {
+  __kmp_stg_parse_int(name, value, 1, KMP_MAX_CHUNK,
+                      &__kmp_dispatch_chunk_batch);
+} // __kmp_stg_parse_disp_chunk_batch
+
+static void __kmp_stg_print_disp_chunk_batch(kmp_str_buf_t *buffer,
+                                             char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_dispatch_chunk_batch);
+} // __kmp_stg_print_disp_chunk_batch
+
 #if KMP_NESTED_HOT_TEAMS
 // -----------------------------------------------------------------------------
 // KMP_HOT_TEAMS_MAX_LEVEL, KMP_HOT_TEAMS_MODE
@@ -1368,8 +1460,68 @@ static void __kmp_stg_print_hot_teams_mode(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_hot_teams_mode);
 } // __kmp_stg_print_hot_teams_mode
 
+// -----------------------------------------------------------------------------
+// KMP_NESTED_TEAMS_CACHE
+
+static void __kmp_stg_parse_nested_teams_cache(char const *name,
+                                               char const *value, void *data) {
+  if (TCR_4(__kmp_init_parallel)) {
+    KMP_WARNING(EnvParallelWarn, name);
+    return;
+  } // read value before first parallel only
+  __kmp_stg_parse_int(name, value, 0, KMP_MAX_NTH, &__kmp_nested_teams_cache);
+} // __kmp_stg_parse_nested_teams_cache
+
+static void __kmp_stg_print_nested_teams_cache(kmp_str_buf_t *buffer,
+                                               char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_nested_teams_cache);
+} // __kmp_stg_print_nested_teams_cache
+
 #endif // KMP_NESTED_HOT_TEAMS
 
+// -----------------------------------------------------------------------------
+// KMP_FAST_FORK
+
+static void __kmp_stg_parse_fast_fork(char const *name, char const *value,
+                                      void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_fast_fork);
+} // __kmp_stg_parse_fast_fork
+
+static void __kmp_stg_print_fast_fork(kmp_str_buf_t *buffer, char const *name,
+                                      void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_fast_fork);
+} // __kmp_stg_print_fast_fork
+
+// -----------------------------------------------------------------------------
+// KMP_PRESPAWN_THREADS
+
+static void __kmp_stg_parse_prespawn_threads(char const *name,
+                                             char const *value, void *data) {
+  if (TCR_4(__kmp_init_parallel)) {
+    KMP_WARNING(EnvParallelWarn, name);
+    return;
+  } // read value before first parallel only
+  if (__kmp_str_match("background", 1, value)) {
+    __kmp_prespawn_threads = 2;
+  } else if (__kmp_str_match_true(value)) {
+    __kmp_prespawn_threads = 1;
+  } else if (__kmp_str_match_false(value)) {
+    __kmp_prespawn_threads = 0;
+  } else {
+    KMP_WARNING(StgInvalidValue, name, value);
+  }
+} // __kmp_stg_parse_prespawn_threads
+
+static void __kmp_stg_print_prespawn_threads(kmp_str_buf_t *buffer,
+                                             char const *name, void *data) {
+  const char *value = "false";
+  if (__kmp_prespawn_threads == 2)
+    value = "background";
+  else if (__kmp_prespawn_threads)
+    value = "true";
+  __kmp_stg_print_str(buffer, name, value);
+} // __kmp_stg_print_prespawn_threads
+
 // -----------------------------------------------------------------------------
 // KMP_HANDLE_SIGNALS
 
@@ -1760,6 +1912,25 @@ static void __kmp_stg_print_force_reduction(kmp_str_buf_t *buffer,
 
 } // __kmp_stg_print_force_reduction
 
+// -----------------------------------------------------------------------------
+// KMP_FUSED_REDUCTION_BARRIER
+
+// Blocking reductions (__kmpc_reduce) normally end with their own barrier. The
+// compiler may emit another barrier right after __kmpc_end_reduce() (clang
+// does for worksharing constructs without nowait); this setting lets the
+// runtime rely on that barrier and skip its own release phase.
+static void __kmp_stg_parse_fused_reduction_barrier(char const *name,
+                                                    char const *value,
+                                                    void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_fused_reduction_barrier);
+} // __kmp_stg_parse_fused_reduction_barrier
+
+static void __kmp_stg_print_fused_reduction_barrier(kmp_str_buf_t *buffer,
+                                                    char const *name,
+                                                    void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_fused_reduction_barrier);
+} // __kmp_stg_print_fused_reduction_barrier
+
 // -----------------------------------------------------------------------------
 // KMP_STORAGE_MAP
 
@@ -3860,6 +4031,19 @@ static void __kmp_stg_print_kmp_hand_thread(kmp_str_buf_t *buffer,
                                             char const *name, void *data) {
   __kmp_stg_print_bool(buffer, name, __kmp_dispatch_hand_threading);
 } // __kmp_stg_print_kmp_hand_thread
+
+// -----------------------------------------------------------------------------
+// KMP_DISP_HIER_AUTO
+static void __kmp_stg_parse_disp_hier_auto(char const *name, char const *value,
+                                           void *data) {
+  __kmp_stg_parse_int(name, value, 0, KMP_MAX_NTH, &__kmp_dispatch_hier_auto);
+  __kmp_env_disp_hier_auto = TRUE;
+} // __kmp_stg_parse_disp_hier_auto
+
+static void __kmp_stg_print_disp_hier_auto(kmp_str_buf_t *buffer,
+                                           char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_dispatch_hier_auto);
+} // __kmp_stg_print_disp_hier_auto
 #endif
 
 // -----------------------------------------------------------------------------
@@ -3867,8 +4051,8 @@ static void __kmp_stg_print_kmp_hand_thread(kmp_str_buf_t *buffer,
 
 static void __kmp_stg_parse_atomic_mode(char const *name, char const *value,
                                         void *data) {
-  // Modes: 0 -- do not change default; 1 -- Intel perf mode, 2 -- GOMP
-  // compatibility mode.
+  // Modes: 0 -- do not change default; 1 -- Intel perf mode (default), 2 --
+  // GOMP compatibility mode, all atomics serialized by one lock.
   int mode = 0;
   int max = 1;
 #ifdef KMP_GOMP_COMPAT
@@ -3888,6 +4072,21 @@ static void __kmp_stg_print_atomic_mode(kmp_str_buf_t *buffer, char const *name,
   __kmp_stg_print_int(buffer, name, __kmp_atomic_mode);
 } // __kmp_stg_print_atomic_mode
 
+// -----------------------------------------------------------------------------
+// KMP_ATOMIC_COMBINE
+
+static void __kmp_stg_parse_atomic_combine(char const *name, char const *value,
+                                           void *data) {
+  // Number of failed compare and stores of a double addition before it is
+  // combined with the other pending ones, 0 -- never.
+  __kmp_stg_parse_int(name, value, 0, INT_MAX, &__kmp_atomic_combine);
+} // __kmp_stg_parse_atomic_combine
+
+static void __kmp_stg_print_atomic_combine(kmp_str_buf_t *buffer,
+                                           char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_atomic_combine);
+} // __kmp_stg_print_atomic_combine
+
 // -----------------------------------------------------------------------------
 // KMP_CONSISTENCY_CHECK
 
@@ -4115,6 +4314,15 @@ static void __kmp_stg_parse_lock_kind(char const *name, char const *value,
     __kmp_user_lock_kind = lk_hle;
     KMP_STORE_LOCK_SEQ(hle);
   }
+#endif
+#if KMP_USE_DYNAMIC_LOCK
+  else if (__kmp_str_match("cohort", 1, value)) {
+    __kmp_user_lock_kind = lk_cohort;
+    KMP_STORE_LOCK_SEQ(cohort);
+  } else if (__kmp_str_match("hybrid", 2, value)) {
+    __kmp_user_lock_kind = lk_hybrid;
+    KMP_STORE_LOCK_SEQ(hybrid);
+  }
 #endif
   else {
     KMP_WARNING(StgInvalidValue, name, value);
@@ -4165,6 +4373,15 @@ static void __kmp_stg_print_lock_kind(kmp_str_buf_t *buffer, char const *name,
   case lk_adaptive:
     value = "adaptive";
     break;
+#endif
+#if KMP_USE_DYNAMIC_LOCK
+  case lk_cohort:
+    value = "cohort";
+    break;
+
+  case lk_hybrid:
+    value = "hybrid";
+    break;
 #endif
   }
 
@@ -4173,6 +4390,58 @@ static void __kmp_stg_print_lock_kind(kmp_str_buf_t *buffer, char const *name,
   }
 }
 
+// -----------------------------------------------------------------------------
+// KMP_LOCK_PARK
+
+// Lets waiters of queuing and drdpa locks sleep once they have spun for the
+// blocktime instead of spinning until they get the lock.
+static void __kmp_stg_parse_lock_park(char const *name, char const *value,
+                                      void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_lock_park);
+} // __kmp_stg_parse_lock_park
+
+static void __kmp_stg_print_lock_park(kmp_str_buf_t *buffer, char const *name,
+                                      void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_lock_park);
+} // __kmp_stg_print_lock_park
+
+#if KMP_USE_DYNAMIC_LOCK
+// -----------------------------------------------------------------------------
+// KMP_COHORT_HANDOFFS
+
+// Number of times in a row a cohort lock may pass between threads of one node
+// before the node has to give up the global lock.
+static void __kmp_stg_parse_cohort_handoffs(char const *name,
+                                            char const *value, void *data) {
+  __kmp_stg_parse_int(name, value, 0, INT_MAX, &__kmp_cohort_handoffs);
+} // __kmp_stg_parse_cohort_handoffs
+
+static void __kmp_stg_print_cohort_handoffs(kmp_str_buf_t *buffer,
+                                            char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_cohort_handoffs);
+} // __kmp_stg_print_cohort_handoffs
+
+// -----------------------------------------------------------------------------
+// KMP_LOCK_PROFILE
+
+// Profiles the contention of indirect locks and reports the given number of
+// lock sites with the longest wait times at exit; 0 disables profiling.
+static void __kmp_stg_parse_lock_profile(char const *name, char const *value,
+                                         void *data) {
+  if (__kmp_init_user_locks) {
+    // the size of the lock objects is fixed once locks exist
+    KMP_WARNING(EnvLockWarn, name);
+    return;
+  }
+  __kmp_stg_parse_int(name, value, 0, INT_MAX, &__kmp_lock_profile);
+} // __kmp_stg_parse_lock_profile
+
+static void __kmp_stg_print_lock_profile(kmp_str_buf_t *buffer,
+                                         char const *name, void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_lock_profile);
+} // __kmp_stg_print_lock_profile
+#endif // KMP_USE_DYNAMIC_LOCK
+
 // -----------------------------------------------------------------------------
 // KMP_SPIN_BACKOFF_PARAMS
 
@@ -4757,12 +5026,30 @@ static kmp_setting_t __kmp_stg_table[] = {
      __kmp_stg_print_wait_policy, NULL, 0, 0},
     {"KMP_DISP_NUM_BUFFERS", __kmp_stg_parse_disp_buffers,
      __kmp_stg_print_disp_buffers, NULL, 0, 0},
+    {"KMP_DISP_ELASTIC", __kmp_stg_parse_disp_elastic,
+     __kmp_stg_print_disp_elastic, NULL, 0, 0},
+    {"KMP_STEAL_PAIR", __kmp_stg_parse_steal_pair, __kmp_stg_print_steal_pair,
+     NULL, 0, 0},
+    {"KMP_DOACROSS_WINDOW", __kmp_stg_parse_doacross_window,
+     __kmp_stg_print_doacross_window, NULL, 0, 0},
+    {"KMP_DIST_ELEMENT_SIZE", __kmp_stg_parse_dist_elem_size,
+     __kmp_stg_print_dist_elem_size, NULL, 0, 0},
+    {"KMP_ADAPTIVE_AUTO", __kmp_stg_parse_adaptive_auto,
+     __kmp_stg_print_adaptive_auto, NULL, 0, 0},
+    {"KMP_DISP_CHUNK_BATCH", __kmp_stg_parse_disp_chunk_batch,
+     __kmp_stg_print_disp_chunk_batch, NULL, 0, 0},
 #if KMP_NESTED_HOT_TEAMS
     {"KMP_HOT_TEAMS_MAX_LEVEL", __kmp_stg_parse_hot_teams_level,
      __kmp_stg_print_hot_teams_level, NULL, 0, 0},
     {"KMP_HOT_TEAMS_MODE", __kmp_stg_parse_hot_teams_mode,
      __kmp_stg_print_hot_teams_mode, NULL, 0, 0},
+    {"KMP_NESTED_TEAMS_CACHE", __kmp_stg_parse_nested_teams_cache,
+     __kmp_stg_print_nested_teams_cache, NULL, 0, 0},
 #endif // KMP_NESTED_HOT_TEAMS
+    {"KMP_FAST_FORK", __kmp_stg_parse_fast_fork, __kmp_stg_print_fast_fork,
+     NULL, 0, 0},
+    {"KMP_PRESPAWN_THREADS", __kmp_stg_parse_prespawn_threads,
+     __kmp_stg_print_prespawn_threads, NULL, 0, 0},
 
 #if KMP_HANDLE_SIGNALS
     {"KMP_HANDLE_SIGNALS", __kmp_stg_parse_handle_signals,
@@ -4832,6 +5119,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      __kmp_stg_print_force_reduction, NULL, 0, 0},
     {"KMP_DETERMINISTIC_REDUCTION", __kmp_stg_parse_force_reduction,
      __kmp_stg_print_force_reduction, NULL, 0, 0},
+    {"KMP_FUSED_REDUCTION_BARRIER", __kmp_stg_parse_fused_reduction_barrier,
+     __kmp_stg_print_fused_reduction_barrier, NULL, 0, 0},
     {"KMP_STORAGE_MAP", __kmp_stg_parse_storage_map,
      __kmp_stg_print_storage_map, NULL, 0, 0},
     {"KMP_ALL_THREADPRIVATE", __kmp_stg_parse_all_threadprivate,
@@ -4874,9 +5163,13 @@ static kmp_setting_t __kmp_stg_table[] = {
 #if KMP_USE_HIER_SCHED
     {"KMP_DISP_HAND_THREAD", __kmp_stg_parse_kmp_hand_thread,
      __kmp_stg_print_kmp_hand_thread, NULL, 0, 0},
+    {"KMP_DISP_HIER_AUTO", __kmp_stg_parse_disp_hier_auto,
+     __kmp_stg_print_disp_hier_auto, NULL, 0, 0},
 #endif
     {"KMP_ATOMIC_MODE", __kmp_stg_parse_atomic_mode,
      __kmp_stg_print_atomic_mode, NULL, 0, 0},
+    {"KMP_ATOMIC_COMBINE", __kmp_stg_parse_atomic_combine,
+     __kmp_stg_print_atomic_combine, NULL, 0, 0},
     {"KMP_CONSISTENCY_CHECK", __kmp_stg_parse_consistency_check,
      __kmp_stg_print_consistency_check, NULL, 0, 0},
 
@@ -4902,6 +5195,14 @@ static kmp_setting_t __kmp_stg_table[] = {
      __kmp_stg_print_lock_block, NULL, 0, 0},
     {"KMP_LOCK_KIND", __kmp_stg_parse_lock_kind, __kmp_stg_print_lock_kind,
      NULL, 0, 0},
+    {"KMP_LOCK_PARK", __kmp_stg_parse_lock_park, __kmp_stg_print_lock_park,
+     NULL, 0, 0},
+#if KMP_USE_DYNAMIC_LOCK
+    {"KMP_COHORT_HANDOFFS", __kmp_stg_parse_cohort_handoffs,
+     __kmp_stg_print_cohort_handoffs, NULL, 0, 0},
+    {"KMP_LOCK_PROFILE", __kmp_stg_parse_lock_profile,
+     __kmp_stg_print_lock_profile, NULL, 0, 0},
+#endif
     {"KMP_SPIN_BACKOFF_PARAMS", __kmp_stg_parse_spin_backoff_params,
      __kmp_stg_print_spin_backoff_params, NULL, 0, 0},
 #if KMP_USE_ADAPTIVE_LOCKS
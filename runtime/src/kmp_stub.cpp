@@ -141,6 +141,18 @@ void kmp_set_library(omp_int_t arg) {
 }
 void kmp_set_defaults(char const *str) { i; }
 void kmp_set_disp_num_buffers(omp_int_t arg) { i; }
+void kmpc_set_loop_weights(char const *loop, const kmp_uint64 *prefix_sum,
+                           size_t n) {}
+void kmpc_set_dist_element_size(size_t size) {}
+void kmpc_print_lock_profile(int n) {}
+void kmpc_init_rw_lock(omp_lock_t *lock) {}
+void kmpc_destroy_rw_lock(omp_lock_t *lock) {}
+void kmpc_set_rd_lock(omp_lock_t *lock) {}
+void kmpc_unset_rd_lock(omp_lock_t *lock) {}
+int kmpc_test_rd_lock(omp_lock_t *lock) { return 1; }
+void kmpc_set_wr_lock(omp_lock_t *lock) {}
+void kmpc_unset_wr_lock(omp_lock_t *lock) {}
+int kmpc_test_wr_lock(omp_lock_t *lock) { return 1; }
 
 /* KMP memory management functions. */
 void *kmp_malloc(size_t size) {
@@ -170,6 +170,7 @@ void __kmp_query_cpuid(kmp_cpuinfo_t *p) {
     }
 
     p->sse2 = (buf.edx >> 26) & 1;
+    p->cmpxchg16b = (buf.ecx >> 13) & 1;
 
 #ifdef KMP_DEBUG
 
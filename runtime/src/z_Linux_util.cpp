@@ -876,6 +876,44 @@ void __kmp_create_worker(int gtid, kmp_info_t *th, size_t stack_size) {
 
 } // __kmp_create_worker
 
+static pthread_t __kmp_prespawn_handle;
+static int __kmp_prespawn_started = FALSE;
+
+/* Start the helper thread that builds the thread pool in the background.
+   Returns FALSE if the thread could not be created; the caller then spawns
+   the pool synchronously. */
+int __kmp_create_prespawn_thread(void *(*func)(void *)) {
+  int status;
+
+  KMP_DEBUG_ASSERT(!__kmp_prespawn_started);
+  status = pthread_create(&__kmp_prespawn_handle, NULL, func, NULL);
+  if (status != 0) {
+    KA_TRACE(10, ("__kmp_create_prespawn_thread: pthread_create failed "
+                  "(%d)\n",
+                  status));
+    return FALSE;
+  }
+  __kmp_prespawn_started = TRUE;
+  KA_TRACE(10, ("__kmp_create_prespawn_thread: helper started\n"));
+  return TRUE;
+} // __kmp_create_prespawn_thread
+
+/* Wait for the helper thread so it does not race with library shutdown. */
+void __kmp_join_prespawn_thread(void) {
+  int status;
+
+  if (!__kmp_prespawn_started ||
+      pthread_equal(pthread_self(), __kmp_prespawn_handle))
+    return;
+  __kmp_prespawn_started = FALSE;
+  status = pthread_join(__kmp_prespawn_handle, NULL);
+  if (status != 0 && status != ESRCH) {
+    __kmp_msg(kmp_ms_warning, KMP_MSG(ReapWorkerError), KMP_ERR(status),
+              __kmp_msg_null);
+  }
+  KA_TRACE(10, ("__kmp_join_prespawn_thread: helper joined\n"));
+} // __kmp_join_prespawn_thread
+
 #if KMP_USE_MONITOR
 void __kmp_create_monitor(kmp_info_t *th) {
   pthread_t handle;
@@ -1298,6 +1336,7 @@ static void __kmp_atfork_child(void) {
   TCW_4(__kmp_nth, 0);
 
   __kmp_thread_pool = NULL;
+  __kmp_prespawn_started = FALSE;
   __kmp_thread_pool_insert_pt = NULL;
   __kmp_team_pool = NULL;
 
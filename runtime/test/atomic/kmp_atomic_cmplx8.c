@@ -0,0 +1,108 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_NUM_THREADS=7 %libomp-run
+// RUN: env KMP_ATOMIC_MODE=2 %libomp-run
+//
+// 16-byte atomics are done with cmpxchg16b when the target is 16-byte aligned
+// and take a lock otherwise. Both must update the real and imaginary parts
+// together: every value read or captured keeps imag == 2 * real, and the
+// final sums count all updates. The generic __kmpc_atomic_16 and the typed
+// entries, also those for a 16-byte long double, must take the same path for
+// an address, so that they exclude each other.
+#include <stdio.h>
+#include <complex.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_atomic_cmplx8_add(id*, int, double _Complex*, double _Complex);
+  double _Complex __kmpc_atomic_cmplx8_add_cpt(id*, int, double _Complex*,
+                                               double _Complex, int);
+  double _Complex __kmpc_atomic_cmplx8_rd(id*, int, double _Complex*);
+  double _Complex __kmpc_atomic_cmplx8_swp(id*, int, double _Complex*,
+                                           double _Complex);
+  void __kmpc_atomic_float10_add(id*, int, long double*, long double);
+  void __kmpc_atomic_16(id*, int, void*, void*, void (*)(void*, void*, void*));
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+
+#define ITERS 5000
+
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+
+// aligned is 16-byte aligned, unaligned is only 8-byte aligned
+static struct {
+  double _Complex aligned;
+  double pad;
+  double _Complex unaligned;
+  long double ld;
+} __attribute__((aligned(16))) data;
+
+static int check(double _Complex v) { return cimag(v) == 2.0 * creal(v); }
+
+// The operations the compiler passes to __kmpc_atomic_16.
+static void add_cmplx8(void *out, void *lhs, void *rhs) {
+  *(double _Complex *)out = *(double _Complex *)lhs + *(double _Complex *)rhs;
+}
+static void add_float10(void *out, void *lhs, void *rhs) {
+  *(long double *)out = *(long double *)lhs + *(long double *)rhs;
+}
+
+int main() {
+  int nthreads = 1, errors = 0;
+  double _Complex one = 1.0 + 2.0 * I;
+  long double ld_one = 1.0L;
+
+  #pragma omp parallel shared(nthreads) reduction(+:errors)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int it;
+    double _Complex *p;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (it = 0; it < ITERS; ++it) {
+      p = (it & 1) ? &data.unaligned : &data.aligned;
+      __kmpc_atomic_cmplx8_add(&loc, gtid, p, one);
+      if (!check(__kmpc_atomic_cmplx8_add_cpt(&loc, gtid, p, one, it & 2)))
+        errors++;
+      if (!check(__kmpc_atomic_cmplx8_rd(&loc, gtid, p)))
+        errors++;
+      __kmpc_atomic_16(&loc, gtid, p, &one, add_cmplx8);
+      __kmpc_atomic_float10_add(&loc, gtid, &data.ld, 1.0L);
+      __kmpc_atomic_16(&loc, gtid, &data.ld, &ld_one, add_float10);
+    }
+  }
+  if (creal(data.aligned) != (double)nthreads * ITERS * 3 / 2 ||
+      creal(data.unaligned) != (double)nthreads * ITERS * 3 / 2 ||
+      !check(data.aligned) || !check(data.unaligned) ||
+      data.ld != (long double)nthreads * ITERS * 2)
+    errors++;
+
+  // swap hands back the previous value
+  if (!check(__kmpc_atomic_cmplx8_swp(&loc, 0, &data.aligned, 0.0)) ||
+      data.aligned != 0.0)
+    errors++;
+
+  if (errors) {
+    fprintf(stderr, "%d errors: (%f, %f) (%f, %f)\n", errors,
+            creal(data.aligned), cimag(data.aligned), creal(data.unaligned),
+            cimag(data.unaligned));
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -0,0 +1,143 @@
+// RUN: %libomp-compile
+// RUN: env KMP_ATOMIC_COMBINE=0 %libomp-run
+// RUN: env KMP_ATOMIC_COMBINE=1 %libomp-run
+// RUN: env KMP_ATOMIC_COMBINE=4 OMP_NUM_THREADS=7 %libomp-run
+// RUN: env KMP_ATOMIC_COMBINE=4 KMP_ATOMIC_MODE=2 %libomp-run
+//
+// Atomic additions to shared doubles. With KMP_ATOMIC_COMBINE=<n> threads
+// that fail the compare and store n times hand their operands to a combiner
+// instead of retrying, 0 disables combining. No addition may get lost either
+// way, also for several accumulators sharing a combining slot and for
+// subtractions: all values stay exactly representable, so the sums are exact.
+//
+// The test also serves as the contention benchmark. It is only timed when
+// ATOMIC_COMBINE_BENCH is set, e.g. after the lit run
+//   env ATOMIC_COMBINE_BENCH=1 OMP_NUM_THREADS=16 KMP_ATOMIC_COMBINE=4 <binary>
+// Then all threads add to one double, first with a plain compare-and-swap loop
+// written here and then with __kmpc_atomic_float8_add. The program prints the
+// time per addition of both, and the speedup of the runtime's addition.
+// Running it again with KMP_ATOMIC_COMBINE=0 gives the runtime's addition
+// without combining.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_atomic_float8_add(id*, int, double*, double);
+  void __kmpc_atomic_float8_sub(id*, int, double*, double);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+
+#define ITERS 100000
+#define ACCS 4
+#define BENCH_ITERS 1000000
+
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+static double sum;
+static double acc[ACCS];
+static double bench_sum;
+
+// The plain compare-and-swap loop the benchmark compares with.
+static void cas_add(double *p, double v) {
+  union {
+    double d;
+    long long i;
+  } old_val, new_val;
+  do {
+    old_val.i = *(volatile long long *)p;
+    new_val.d = old_val.d + v;
+  } while (!__sync_bool_compare_and_swap((long long *)p, old_val.i,
+                                         new_val.i));
+}
+
+// Times BENCH_ITERS additions per thread to one double, with the plain loop
+// if plain is set, and returns the nanoseconds per addition; -1 if an
+// addition got lost.
+static double bench(int plain) {
+  int nthreads = 1;
+  double start = 0, time;
+
+  bench_sum = 0;
+  #pragma omp parallel shared(nthreads, start)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int it;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    #pragma omp master
+    start = omp_get_wtime();
+    #pragma omp barrier
+    if (plain) {
+      for (it = 0; it < BENCH_ITERS; ++it)
+        cas_add(&bench_sum, 1.0);
+    } else {
+      for (it = 0; it < BENCH_ITERS; ++it)
+        __kmpc_atomic_float8_add(&loc, gtid, &bench_sum, 1.0);
+    }
+  }
+  time = omp_get_wtime() - start;
+  if (bench_sum != (double)nthreads * BENCH_ITERS)
+    return -1;
+  return time * 1e9 / ((double)nthreads * BENCH_ITERS);
+}
+
+int main() {
+  int i, nthreads = 1, errors = 0;
+
+  #pragma omp parallel shared(nthreads)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int it;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (it = 0; it < ITERS; ++it) {
+      __kmpc_atomic_float8_add(&loc, gtid, &sum, 1.0);
+      if (it % 8 == 0) {
+        __kmpc_atomic_float8_add(&loc, gtid, &acc[it / 8 % ACCS], 2.0);
+        __kmpc_atomic_float8_sub(&loc, gtid, &acc[(it / 8 + 1) % ACCS], 1.0);
+      }
+    }
+  }
+
+  // all values stay exactly representable
+  if (sum != (double)nthreads * ITERS) {
+    fprintf(stderr, "sum %f, expected %f\n", sum, (double)nthreads * ITERS);
+    errors++;
+  }
+  for (i = 0; i < ACCS; ++i) {
+    if (acc[i] != (double)nthreads * ITERS / 8 / ACCS) {
+      fprintf(stderr, "acc[%d] %f\n", i, acc[i]);
+      errors++;
+    }
+  }
+  if (getenv("ATOMIC_COMBINE_BENCH") != NULL) {
+    double plain = bench(1), runtime = bench(0);
+    if (plain < 0 || runtime < 0) {
+      fprintf(stderr, "benchmark lost additions\n");
+      errors++;
+    } else {
+      printf("%d threads: plain CAS loop %.1f ns, __kmpc_atomic_float8_add "
+             "%.1f ns per addition, speedup %.2f\n",
+             nthreads, plain, runtime, plain / runtime);
+    }
+  }
+  if (errors == 0)
+    printf("passed\n");
+  return errors;
+}
@@ -0,0 +1,71 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_NUM_THREADS=7 %libomp-run
+// RUN: env KMP_ATOMIC_MODE=2 %libomp-run
+//
+// Atomics on types without a native implementation take a lock picked by the
+// target address, or the single global lock in GOMP compatibility mode. The
+// updates of every element, neighbouring ones sharing a cache line and far
+// apart ones, must stay atomic either way.
+#include <stdio.h>
+#include <complex.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_atomic_float10_add(id*, int, long double*, long double);
+  void __kmpc_atomic_cmplx8_add(id*, int, double _Complex*, double _Complex);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+
+#define N 64
+#define ITERS 1000
+
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+static long double ld[N];
+static double _Complex cd[N];
+
+int main() {
+  int i, nthreads = 1, errors = 0;
+
+  #pragma omp parallel shared(nthreads)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int it, j;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (it = 0; it < ITERS; ++it) {
+      for (j = 0; j < N; ++j) {
+        __kmpc_atomic_float10_add(&loc, gtid, &ld[j], 1.0L);
+        __kmpc_atomic_cmplx8_add(&loc, gtid, &cd[j], 1.0 + 2.0 * I);
+      }
+    }
+  }
+
+  for (i = 0; i < N; ++i) {
+    if (ld[i] != (long double)nthreads * ITERS ||
+        creal(cd[i]) != (double)nthreads * ITERS ||
+        cimag(cd[i]) != 2.0 * nthreads * ITERS) {
+      fprintf(stderr, "element %d: %Lf (%f, %f)\n", i, ld[i], creal(cd[i]),
+              cimag(cd[i]));
+      errors++;
+    }
+  }
+  if (errors == 0)
+    printf("passed\n");
+  return errors;
+}
@@ -0,0 +1,96 @@
+// RUN: %libomp-compile
+// RUN: env KMP_LOCK_KIND=hybrid %libomp-run
+// RUN: env KMP_LOCK_KIND=hybrid KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_KIND=hybrid OMP_NUM_THREADS=7 %libomp-run
+// RUN: env KMP_LOCK_KIND=hybrid KMP_LOCK_PROFILE=2 OMP_NUM_THREADS=4 \
+// RUN:   %libomp-run 2>&1 | FileCheck %s
+// REQUIRES: filecheck
+//
+// Hybrid locks switch between a test and set lock and a queuing lock as the
+// contention changes. Critical sections and locks must stay mutually exclusive
+// through phases where all threads compete and phases where one thread runs
+// alone, which move the lock back and forth. The switches are counted in the
+// lock profile: with several threads, each lock must have been upgraded and
+// downgraded.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define N 2000
+
+int test_omp_critical_hybrid() {
+  omp_lock_t lck;
+  // The critical section and the lock guard their own counters
+  int counter[2] = {0, 0}, inside[2] = {0, 0};
+  int errors = 0;
+  int nthreads = 1;
+
+  omp_init_lock(&lck);
+  #pragma omp parallel shared(counter, inside, nthreads) reduction(+:errors)
+  {
+    int phase, i;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    for (phase = 0; phase < 4; ++phase) {
+      // contended phase
+      for (i = 0; i < N; ++i) {
+        #pragma omp critical
+        {
+          if (inside[0]++ != 0)
+            errors++;
+          counter[0]++;
+          inside[0]--;
+        }
+        if (omp_test_lock(&lck)) {
+          if (inside[1]++ != 0)
+            errors++;
+          inside[1]--;
+          omp_unset_lock(&lck);
+        }
+        omp_set_lock(&lck);
+        if (inside[1]++ != 0)
+          errors++;
+        counter[1]++;
+        inside[1]--;
+        omp_unset_lock(&lck);
+      }
+      #pragma omp barrier
+      // uncontended phase
+      #pragma omp single
+      for (i = 0; i < N; ++i) {
+        #pragma omp critical
+        counter[0]++;
+        omp_set_lock(&lck);
+        counter[1]++;
+        omp_unset_lock(&lck);
+      }
+    }
+  }
+  omp_destroy_lock(&lck);
+
+  if (counter[0] != 4 * N * (nthreads + 1) ||
+      counter[1] != 4 * N * (nthreads + 1))
+    errors++;
+  if (errors)
+    fprintf(stderr, "%d errors, counters %d %d\n", errors, counter[0],
+            counter[1]);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_critical_hybrid()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
+
+// A site that has switched at least twice has been upgraded to the queuing
+// lock and downgraded back to test and set.
+// CHECK: Lock profile: 2 of 2 lock sites by wait time
+// CHECK-NEXT: acquires contended wait max hold switches location
+// CHECK-NEXT: {{^( +[0-9]+){4} +([2-9]|[1-9][0-9]+) }}
+// CHECK-NEXT: {{^( +[0-9]+){4} +([2-9]|[1-9][0-9]+) }}
@@ -0,0 +1,74 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_COHORT_HANDOFFS=0 %libomp-run
+// RUN: env KMP_LOCK_KIND=cohort KMP_COHORT_HANDOFFS=1 %libomp-run
+//
+// Cohort locks, requested with kmp_lock_hint_cohort or picked for contended
+// locks and critical sections, must provide mutual exclusion for set, test
+// and critical, also when the local lock of a node is handed over in a row.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define N 2000
+
+int test_omp_lock_cohort() {
+  omp_lock_t lck, clck;
+  // Each kind of lock guards its own counters
+  int counter[3] = {0, 0, 0}, inside[3] = {0, 0, 0};
+  int errors = 0, k;
+
+  omp_init_lock_with_hint(&lck, kmp_lock_hint_cohort);
+  omp_init_lock_with_hint(&clck, omp_lock_hint_contended);
+
+  #pragma omp parallel shared(counter, inside) reduction(+:errors)
+  {
+    int i;
+    for (i = 0; i < N; ++i) {
+      omp_set_lock(&lck);
+      if (inside[0]++ != 0)
+        errors++;
+      counter[0]++;
+      inside[0]--;
+      omp_unset_lock(&lck);
+
+      while (!omp_test_lock(&clck))
+        ;
+      if (inside[1]++ != 0)
+        errors++;
+      counter[1]++;
+      inside[1]--;
+      omp_unset_lock(&clck);
+
+      #pragma omp critical
+      {
+        if (inside[2]++ != 0)
+          errors++;
+        counter[2]++;
+        inside[2]--;
+      }
+    }
+  }
+
+  omp_destroy_lock(&lck);
+  omp_destroy_lock(&clck);
+  for (k = 0; k < 3; ++k) {
+    if (counter[k] != N * omp_get_max_threads()) {
+      fprintf(stderr, "counter %d is %d\n", k, counter[k]);
+      errors++;
+    }
+  }
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_lock_cohort()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
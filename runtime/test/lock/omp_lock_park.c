@@ -0,0 +1,57 @@
+// RUN: %libomp-compile
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=queuing KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=queuing KMP_BLOCKTIME=1 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=drdpa KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=drdpa KMP_BLOCKTIME=1 %libomp-run
+// RUN: env KMP_LOCK_PARK=1 KMP_LOCK_KIND=drdpa KMP_BLOCKTIME=0 \
+// RUN:   OMP_NUM_THREADS=7 %libomp-run
+//
+// Waiters of queuing and drdpa locks that have spun for the blocktime sleep
+// until the owner wakes them: every waiter must be woken, also after the
+// drdpa polling area has grown, and the locks still have to exclude.
+#include <stdio.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define N 500
+
+int test_omp_lock_park() {
+  omp_lock_t lck;
+  int counter = 0, inside = 0, errors = 0;
+
+  omp_init_lock(&lck);
+  #pragma omp parallel shared(counter, inside) reduction(+:errors)
+  {
+    int i;
+    for (i = 0; i < N; ++i) {
+      omp_set_lock(&lck);
+      if (inside++ != 0)
+        errors++;
+      counter++;
+      // Hold the lock long enough now and then for the others to park
+      if (i % 100 == 0)
+        my_sleep(0.002);
+      inside--;
+      omp_unset_lock(&lck);
+    }
+  }
+  omp_destroy_lock(&lck);
+
+  if (counter != N * omp_get_max_threads())
+    errors++;
+  if (errors)
+    fprintf(stderr, "%d errors, counter %d\n", errors, counter);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_lock_park()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,101 @@
+// RUN: %libomp-compile
+// RUN: env KMP_LOCK_PROFILE=5 %libomp-run 2>&1 | FileCheck %s
+// RUN: env KMP_LOCK_PROFILE=5 KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_PROFILE=5 KMP_LOCK_KIND=drdpa %libomp-run
+// REQUIRES: filecheck
+//
+// Lock profiling wraps the indirect lock functions; locks, nested locks and
+// critical sections must keep working with it, including the lock objects
+// reused after omp_destroy_lock, and the report must be available on demand
+// and at exit, with the acquisitions of each lock counted exactly.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define N 500
+#define NUM_THREADS 4
+
+int test_omp_lock_profile() {
+  omp_lock_t lck;
+  omp_nest_lock_t nlck;
+  // Each lock guards its own counters
+  int counter[3] = {0, 0, 0}, inside[3] = {0, 0, 0};
+  int errors = 0, k;
+
+  omp_init_lock(&lck);
+  omp_init_nest_lock(&nlck);
+
+  #pragma omp parallel num_threads(NUM_THREADS) shared(counter, inside) \
+      reduction(+:errors)
+  {
+    int i;
+    for (i = 0; i < N; ++i) {
+      omp_set_lock(&lck);
+      if (inside[0]++ != 0)
+        errors++;
+      counter[0]++;
+      inside[0]--;
+      omp_unset_lock(&lck);
+
+      while (!omp_test_lock(&lck))
+        ;
+      if (inside[0]++ != 0)
+        errors++;
+      counter[0]++;
+      inside[0]--;
+      omp_unset_lock(&lck);
+
+      omp_set_nest_lock(&nlck);
+      if (omp_test_nest_lock(&nlck) != 2)
+        errors++;
+      if (inside[1]++ != 0)
+        errors++;
+      counter[1]++;
+      inside[1]--;
+      omp_unset_nest_lock(&nlck);
+      omp_unset_nest_lock(&nlck);
+
+      #pragma omp critical(profiled)
+      {
+        if (inside[2]++ != 0)
+          errors++;
+        counter[2]++;
+        inside[2]--;
+      }
+    }
+  }
+
+  omp_destroy_lock(&lck);
+  omp_destroy_nest_lock(&nlck);
+  if (counter[0] != 2 * N * NUM_THREADS)
+    errors++;
+  for (k = 1; k < 3; ++k)
+    if (counter[k] != N * NUM_THREADS)
+      errors++;
+  if (errors)
+    fprintf(stderr, "%d errors, counters %d %d %d\n", errors, counter[0],
+            counter[1], counter[2]);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_lock_profile()) {
+      num_failed++;
+    }
+  }
+  // Over 10 repetitions of 4 threads and 500 iterations each, the lock and
+  // the nested lock (set and test each) are acquired 40000 times and the
+  // critical section 20000 times; the objects of the locks are reused.
+  kmpc_print_lock_profile(3);
+  return num_failed;
+}
+
+// CHECK: Lock profile: 3 of 3 lock sites by wait time
+// CHECK-NEXT: acquires contended wait max hold switches location
+// CHECK-DAG: {{^ *}}40000 {{.*}} 0 lock 0x
+// CHECK-DAG: {{^ *}}40000 {{.*}} 0 lock 0x
+// CHECK-DAG: {{^ *}}20000 {{.*}} {{.+}}:{{[0-9]+}} {{.+}}
+// CHECK: Lock profile: 3 of 3 lock sites by wait time
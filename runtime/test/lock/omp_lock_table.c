@@ -0,0 +1,101 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_PROFILE=1 %libomp-run
+//
+// Threads initialize and destroy indirect locks concurrently without a global
+// lock: the lock table grows while other threads use their locks, locks
+// destroyed by one thread are reused by it or, once its pool spills over, by
+// the others, and all of them must still work as distinct locks. The table
+// must also hold more locks than one block of its directory lists.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define LOCKS 3000 // per thread, several chunks of the lock table
+#define ROUNDS 4
+#define MANY_LOCKS ((1 << 20) + 5000) // past the first directory block
+
+int test_omp_lock_table() {
+  int nthreads = omp_get_max_threads();
+  int errors = 0;
+  omp_lock_t *lcks = (omp_lock_t *)malloc(sizeof(omp_lock_t) * LOCKS *
+                                          nthreads);
+  int *counts = (int *)calloc(LOCKS * nthreads, sizeof(int));
+
+  #pragma omp parallel reduction(+:errors)
+  {
+    int tid = omp_get_thread_num();
+    int n = omp_get_num_threads();
+    int r, j;
+    for (r = 0; r < ROUNDS; ++r) {
+      // Every thread initializes its part of the locks and tests them
+      for (j = tid * LOCKS; j < (tid + 1) * LOCKS; ++j) {
+        omp_init_lock_with_hint(&lcks[j], omp_lock_hint_contended);
+        if (!omp_test_lock(&lcks[j]))
+          errors++;
+      }
+      #pragma omp barrier
+      // The locks of the neighbour are still held
+      for (j = (tid + 1) % n * LOCKS; j < ((tid + 1) % n + 1) * LOCKS; ++j)
+        if (n > 1 && omp_test_lock(&lcks[j]))
+          errors++;
+      #pragma omp barrier
+      for (j = tid * LOCKS; j < (tid + 1) * LOCKS; ++j)
+        omp_unset_lock(&lcks[j]);
+      #pragma omp barrier
+      // All threads count on all locks, then destroy the neighbour's ones
+      for (j = 0; j < LOCKS * n; ++j) {
+        omp_set_lock(&lcks[j]);
+        counts[j]++;
+        omp_unset_lock(&lcks[j]);
+      }
+      #pragma omp barrier
+      for (j = (tid + 1) % n * LOCKS; j < ((tid + 1) % n + 1) * LOCKS; ++j)
+        omp_destroy_lock(&lcks[j]);
+      #pragma omp barrier
+    }
+  }
+
+  for (int j = 0; j < LOCKS * nthreads; ++j) {
+    if (counts[j] != ROUNDS * nthreads) {
+      fprintf(stderr, "lock %d counted %d\n", j, counts[j]);
+      errors++;
+      break;
+    }
+  }
+  free(lcks);
+  free(counts);
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors == 0;
+}
+
+int test_omp_lock_table_many() {
+  int errors = 0;
+  int j;
+  omp_lock_t *lcks = (omp_lock_t *)malloc(sizeof(omp_lock_t) * MANY_LOCKS);
+
+  #pragma omp parallel for reduction(+:errors)
+  for (j = 0; j < MANY_LOCKS; ++j) {
+    omp_init_lock_with_hint(&lcks[j], omp_lock_hint_contended);
+    if (!omp_test_lock(&lcks[j]))
+      errors++;
+  }
+  // All of them are distinct and still held
+  for (j = 0; j < MANY_LOCKS; j += 1009)
+    if (omp_test_lock(&lcks[j]))
+      errors++;
+  #pragma omp parallel for
+  for (j = 0; j < MANY_LOCKS; ++j) {
+    omp_unset_lock(&lcks[j]);
+    omp_destroy_lock(&lcks[j]);
+  }
+  free(lcks);
+  if (errors)
+    fprintf(stderr, "%d errors with many locks\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  return !test_omp_lock_table() || !test_omp_lock_table_many();
+}
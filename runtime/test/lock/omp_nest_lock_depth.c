@@ -0,0 +1,95 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_PROFILE=1 %libomp-run
+//
+// The owner of a nest lock re-acquires and releases it without the indirect
+// lock, also beyond the depth its owner word can count: omp_test_nest_lock
+// must return the exact depth, the lock must stay held until the last release
+// and exclude the other threads all the time.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define DEPTH 70000 // more levels than the owner word counts
+#define N 200
+
+static int errors;
+
+static void recurse(omp_nest_lock_t *lck, int *counter, int level) {
+  omp_set_nest_lock(lck);
+  (*counter)++;
+  if (level > 0)
+    recurse(lck, counter, level - 1);
+  omp_unset_nest_lock(lck);
+}
+
+int test_omp_nest_lock_depth() {
+  omp_nest_lock_t lck;
+  int counter = 0;
+  int i, depth;
+
+  errors = 0;
+  omp_init_nest_lock(&lck);
+
+  // Deep nesting on one thread, with tests reporting the depth on the way
+  for (i = 1; i <= DEPTH; ++i) {
+    if (i % 1000 == 0) {
+      depth = omp_test_nest_lock(&lck);
+      if (depth != i) {
+        fprintf(stderr, "depth %d instead of %d\n", depth, i);
+        errors++;
+      }
+    } else {
+      omp_set_nest_lock(&lck);
+    }
+  }
+  #pragma omp parallel reduction(+:errors)
+  {
+    if (omp_get_thread_num() != 0 && omp_test_nest_lock(&lck))
+      errors++;
+  }
+  // Still held at depth 1 after all other levels are released
+  for (i = DEPTH; i > 1; --i)
+    omp_unset_nest_lock(&lck);
+  if (omp_test_nest_lock(&lck) != 2)
+    errors++;
+  omp_unset_nest_lock(&lck);
+  #pragma omp parallel reduction(+:errors)
+  {
+    if (omp_get_thread_num() != 0 && omp_test_nest_lock(&lck))
+      errors++;
+  }
+  omp_unset_nest_lock(&lck);
+
+  // Recursive acquisitions by all threads
+  #pragma omp parallel shared(counter) reduction(+:errors)
+  {
+    int j;
+    for (j = 0; j < N; ++j) {
+      omp_set_nest_lock(&lck);
+      int c = counter;
+      recurse(&lck, &counter, j % 8);
+      if (counter != c + j % 8 + 1)
+        errors++;
+      omp_unset_nest_lock(&lck);
+    }
+  }
+  omp_destroy_nest_lock(&lck);
+
+  if (counter != N / 8 * 36 * omp_get_max_threads())
+    errors++;
+  if (errors)
+    fprintf(stderr, "%d errors, counter %d\n", errors, counter);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_nest_lock_depth()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
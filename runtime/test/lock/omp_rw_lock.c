@@ -0,0 +1,95 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_CONSISTENCY_CHECK=all %libomp-run
+// RUN: env KMP_LOCK_PROFILE=5 %libomp-run
+//
+// Reader-writer locks let any number of readers in at a time and a writer
+// only alone: readers never see a writer inside, writers never see anybody,
+// readers get in while other threads read and a writer does not.
+#include <stdio.h>
+#include "omp_testsuite.h"
+
+#define N 2000
+
+int test_omp_rw_lock() {
+  omp_lock_t lck;
+  int counter = 0, readers = 0, writers = 0, errors = 0;
+
+  kmpc_init_rw_lock(&lck);
+
+  #pragma omp parallel shared(counter, readers, writers) reduction(+:errors)
+  {
+    int i, r;
+    for (i = 0; i < N; ++i) {
+      if (i % 8 == 0) {
+        if (i % 16 == 0) {
+          kmpc_set_wr_lock(&lck);
+        } else {
+          while (!kmpc_test_wr_lock(&lck))
+            ;
+        }
+        if (writers++ != 0 || readers != 0)
+          errors++;
+        counter++;
+        writers--;
+        kmpc_unset_wr_lock(&lck);
+      } else {
+        if (i % 2) {
+          kmpc_set_rd_lock(&lck);
+        } else {
+          while (!kmpc_test_rd_lock(&lck))
+            ;
+        }
+        #pragma omp atomic
+        readers++;
+        if (writers != 0)
+          errors++;
+        #pragma omp atomic read
+        r = counter;
+        if (r < 0)
+          errors++;
+        #pragma omp atomic
+        readers--;
+        kmpc_unset_rd_lock(&lck);
+      }
+    }
+
+    // All threads read together while the primary thread holds the lock
+    #pragma omp barrier
+    #pragma omp master
+    kmpc_set_rd_lock(&lck);
+    #pragma omp barrier
+    if (omp_get_thread_num() != 0) {
+      if (!kmpc_test_rd_lock(&lck))
+        errors++;
+      else
+        kmpc_unset_rd_lock(&lck);
+    }
+    // A failing writer test may hold off readers for a moment, keep it away
+    // from the reader tests above
+    #pragma omp barrier
+    if (kmpc_test_wr_lock(&lck))
+      errors++;
+    #pragma omp barrier
+    #pragma omp master
+    kmpc_unset_rd_lock(&lck);
+  }
+
+  kmpc_destroy_rw_lock(&lck);
+  if (counter != N / 8 * omp_get_max_threads())
+    errors++;
+  if (errors)
+    fprintf(stderr, "%d errors, counter %d\n", errors, counter);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_rw_lock()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,67 @@
+// RUN: %libomp-compile && %libomp-run
+// RUN: env KMP_NESTED_TEAMS_CACHE=1 %libomp-run
+// RUN: env KMP_NESTED_TEAMS_CACHE=4 %libomp-run
+// RUN: env KMP_NESTED_TEAMS_CACHE=4 OMP_PROC_BIND=spread,close %libomp-run
+//
+// Inner teams of nested parallel regions can be parked on the root and
+// reused by a later fork of the same level, size and binding, possibly from a
+// different outer thread.  Alternate the inner team sizes so that parked teams
+// are both reused and bypassed.
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define REGIONS 300
+
+int test_omp_nested_teams_cache() {
+  int i;
+  int errors = 0;
+
+  omp_set_max_active_levels(2);
+  for (i = 0; i < REGIONS; ++i) {
+    int inner = 2 + i % 3;
+    #pragma omp parallel num_threads(2) reduction(+:errors)
+    {
+      int outer_tid = omp_get_thread_num();
+      int count = 0;
+      int mine = inner + outer_tid; // outer threads use different sizes
+      #pragma omp parallel num_threads(mine) shared(count)
+      {
+        if (omp_get_level() != 2 || omp_get_active_level() != 2 ||
+            omp_get_ancestor_thread_num(1) != outer_tid ||
+            omp_get_num_threads() != mine) {
+          #pragma omp atomic
+          count += 1000;
+        }
+        #pragma omp atomic
+        count++;
+        #pragma omp barrier
+        #pragma omp single
+        {
+          #pragma omp task shared(count)
+          {
+            #pragma omp atomic
+            count += mine;
+          }
+        }
+      }
+      if (count != 2 * mine)
+        errors++;
+    }
+  }
+  if (errors)
+    fprintf(stderr, "%d inner regions had a wrong team\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_nested_teams_cache()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
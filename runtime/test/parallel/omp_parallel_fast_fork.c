@@ -0,0 +1,84 @@
+// RUN: %libomp-compile && %libomp-run
+// RUN: env KMP_FAST_FORK=0 %libomp-run
+// RUN: env OMP_PROC_BIND=close %libomp-run
+//
+// Back-to-back parallel regions reuse the hot team through the fast fork
+// path; changing the team size, the ICVs or the arguments in between must
+// still be honored.
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define REGIONS 1000
+
+int test_omp_parallel_fast_fork() {
+  int i;
+  int errors = 0;
+  int max_threads = omp_get_max_threads();
+  int nthreads = max_threads < 4 ? 4 : max_threads;
+
+  omp_set_num_threads(nthreads);
+  for (i = 0; i < REGIONS; ++i) {
+    int count = 0;
+    int arg = i;
+    int sched_ok = 1;
+    omp_sched_t kind;
+    int chunk;
+
+    // Change the team configuration every so often so the regular fork path
+    // is exercised in between fast forks.
+    if (i % 100 == 50)
+      omp_set_num_threads(nthreads - 1);
+    else if (i % 100 == 51)
+      omp_set_num_threads(nthreads);
+    if (i % 100 == 75)
+      omp_set_schedule(omp_sched_dynamic, 3);
+    else if (i % 100 == 76)
+      omp_set_schedule(omp_sched_static, 0);
+    omp_get_schedule(&kind, &chunk);
+
+    #pragma omp parallel shared(count, sched_ok) firstprivate(arg)
+    {
+      omp_sched_t my_kind;
+      int my_chunk;
+      omp_get_schedule(&my_kind, &my_chunk);
+      if (my_kind != kind || my_chunk != chunk) {
+        #pragma omp atomic write
+        sched_ok = 0;
+      }
+      if (arg == i) {
+        #pragma omp atomic
+        count++;
+      }
+    }
+    if (count != (i % 100 == 50 ? nthreads - 1 : nthreads) || !sched_ok)
+      errors++;
+
+    // A num_threads clause bypasses the fast path for one region only
+    if (i % 10 == 9) {
+      count = 0;
+      #pragma omp parallel num_threads(2) shared(count)
+      {
+        #pragma omp atomic
+        count++;
+      }
+      if (count != 2)
+        errors++;
+    }
+  }
+  if (errors)
+    fprintf(stderr, "%d regions had a wrong team\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_parallel_fast_fork()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
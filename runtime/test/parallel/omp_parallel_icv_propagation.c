@@ -0,0 +1,66 @@
+// RUN: %libomp-compile
+// RUN: env KMP_FORKJOIN_BARRIER_PATTERN=linear,linear %libomp-run
+// RUN: env KMP_FORKJOIN_BARRIER_PATTERN=tree,tree %libomp-run
+// RUN: env KMP_FORKJOIN_BARRIER_PATTERN=hyper,hyper %libomp-run
+// RUN: env KMP_FORKJOIN_BARRIER_PATTERN=hierarchical,hierarchical %libomp-run
+//
+// Workers only refresh their ICVs at a fork when the master's ICVs changed.
+// Check that changes made by the master between regions reach every worker
+// and that changes a worker makes inside a region do not leak into the next
+// one.
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define REGIONS 200
+
+int test_omp_parallel_icv_propagation() {
+  int i;
+  int errors = 0;
+
+  omp_set_num_threads(4);
+  omp_set_dynamic(0);
+  kmp_set_blocktime(10);
+  for (i = 0; i < REGIONS; ++i) {
+    int chunk = 1 + i / 10; // changes every tenth region
+    omp_set_schedule(omp_sched_dynamic, chunk);
+    #pragma omp parallel reduction(+:errors)
+    {
+      omp_sched_t kind;
+      int my_chunk;
+      omp_get_schedule(&kind, &my_chunk);
+      if (kind != omp_sched_dynamic || my_chunk != chunk)
+        errors++;
+      if (omp_get_max_threads() != 4)
+        errors++;
+      if (kmp_get_blocktime() != 10)
+        errors++;
+      // Worker-local changes must be discarded at the end of the region
+      if (omp_get_thread_num() != 0 && i % 3 == 0) {
+        omp_set_schedule(omp_sched_guided, 100);
+        omp_set_num_threads(7);
+      }
+      // Also when they are made from an explicit task
+      if (omp_get_thread_num() != 0 && i % 3 == 1) {
+        #pragma omp task
+        kmp_set_blocktime(50);
+        #pragma omp taskwait
+      }
+    }
+  }
+  if (errors)
+    fprintf(stderr, "%d ICV mismatches\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_parallel_icv_propagation()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
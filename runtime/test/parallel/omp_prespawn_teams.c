@@ -0,0 +1,111 @@
+// RUN: %libomp-compile && env KMP_TEAMS_THREAD_LIMIT=12 %libomp-run
+// RUN: env KMP_TEAMS_THREAD_LIMIT=12 KMP_PRESPAWN_THREADS=true %libomp-run
+// RUN: env KMP_TEAMS_THREAD_LIMIT=12 KMP_PRESPAWN_THREADS=background \
+// RUN:   %libomp-run
+//
+// A teams construct that is the first construct of the program initializes
+// the runtime between pushing num_teams and forking the league.  Creating
+// the thread pool at that point must not consume the pushed request: the
+// league must have exactly the requested teams, each running its parallel
+// region, with the requested threads if there are any.  The compiler's code generation is
+// emulated with the __kmpc entries, as gcc does not use them for teams.
+#include <stdio.h>
+#include <omp.h>
+
+#define N_TEAMS 3
+#define N_THR 2
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_push_num_teams(id*, int, int, int);
+  void __kmpc_fork_teams(id*, int, void*, ...);
+  void __kmpc_fork_call(id*, int, void*, ...);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+
+static int seen[N_TEAMS];
+static int threads[N_TEAMS];
+static int errors;
+
+// Outlined parallel region inside a team.
+static void parallel_body(int *gtid, int *tid) {
+  #pragma omp atomic
+  threads[omp_get_team_num()]++;
+}
+
+// Outlined teams region: the master of each team runs it.
+static void teams_body(int *gtid, int *tid) {
+  int team = omp_get_team_num();
+
+  if (omp_get_num_teams() != N_TEAMS || team < 0 || team >= N_TEAMS) {
+    fprintf(stderr, "team %d of %d\n", team, omp_get_num_teams());
+    #pragma omp atomic
+    errors++;
+    return;
+  }
+  #pragma omp atomic
+  seen[team]++;
+  __kmpc_fork_call(&loc, 0, (void *)parallel_body);
+}
+
+// Runs a league of N_TEAMS teams of nthr threads, any number if nthr is 0;
+// returns the number of errors.
+static int run_league(int gtid, int nthr) {
+  int i;
+
+  errors = 0;
+  for (i = 0; i < N_TEAMS; ++i)
+    seen[i] = threads[i] = 0;
+  __kmpc_push_num_teams(&loc, gtid, N_TEAMS, nthr);
+  __kmpc_fork_teams(&loc, 0, (void *)teams_body);
+  for (i = 0; i < N_TEAMS; ++i) {
+    if (seen[i] != 1 || threads[i] < 1 || (nthr && threads[i] != nthr)) {
+      fprintf(stderr, "team %d ran %d times, with %d threads\n", i, seen[i],
+              threads[i]);
+      errors++;
+    }
+  }
+  return errors;
+}
+
+int main() {
+  int gtid = __kmpc_global_thread_num(&loc);
+  int count = 0;
+  int failed = 0;
+
+  // teams num_teams(N_TEAMS) as the first construct
+  failed += run_league(gtid, 0);
+  failed += run_league(gtid, N_THR);
+  // The regions after the leagues get full teams
+  #pragma omp parallel num_threads(4) shared(count)
+  {
+    #pragma omp atomic
+    count += omp_get_thread_num() + 1;
+  }
+  if (count != 10) {
+    fprintf(stderr, "wrong team after the leagues\n");
+    failed++;
+  }
+  if (failed) {
+    fprintf(stderr, "failed, %d errors\n", failed);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
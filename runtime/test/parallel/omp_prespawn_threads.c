@@ -0,0 +1,52 @@
+// RUN: %libomp-compile && %libomp-run
+// RUN: env KMP_PRESPAWN_THREADS=true %libomp-run
+// RUN: env KMP_PRESPAWN_THREADS=background %libomp-run
+// RUN: env KMP_PRESPAWN_THREADS=background OMP_PROC_BIND=close %libomp-run
+//
+// With KMP_PRESPAWN_THREADS the worker threads are created when the runtime
+// initializes, either by the initial thread or by a helper thread that hands
+// them over to the thread pool.  Parallel regions started right after
+// initialization, possibly while the helper is still running, must get full
+// teams with the expected thread numbers.
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define REGIONS 100
+
+int test_omp_prespawn_threads() {
+  int i;
+  int errors = 0;
+  int nthreads = omp_get_max_threads();
+
+  for (i = 0; i < REGIONS; ++i) {
+    int count = 0;
+    int team = i % 2 ? nthreads : nthreads + 1;
+    #pragma omp parallel num_threads(team) shared(count)
+    {
+      if (omp_get_num_threads() != team) {
+        #pragma omp atomic
+        count += 1000;
+      }
+      #pragma omp atomic
+      count += omp_get_thread_num() + 1;
+    }
+    if (count != team * (team + 1) / 2)
+      errors++;
+  }
+  if (errors)
+    fprintf(stderr, "%d regions had a wrong team\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_prespawn_threads()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,153 @@
+// RUN: %libomp-compile
+// RUN: env KMP_TEAMS_THREAD_LIMIT=12 %libomp-run
+// RUN: env KMP_TEAMS_THREAD_LIMIT=12 KMP_SCHEDULE=static,balanced %libomp-run
+//
+// The test checks unchunked distribute parallel loops on the host, emulating
+// the compiler's code generation: the blocks of all teams and threads must
+// be contiguous, in order, cover the whole range and report the last
+// iteration once. With an element size hint the boundaries between teams of
+// a unit-stride loop must start a page of elements.
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <omp.h>
+
+#define N_TEAMS 4
+#define N_THR 3
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+enum sched {
+  kmp_sch_static = 34,
+};
+typedef long long i64;
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_push_num_teams(id*, int, int, int);
+  void __kmpc_fork_teams(id*, int, void*, ...);
+  void __kmpc_fork_call(id*, int, void*, ...);
+  void __kmpc_dist_for_static_init_4(id*, int, int, int*, int*, int*, int*,
+                                     int*, int, int);
+  void __kmpc_dist_for_static_init_8(id*, int, int, int*, i64*, i64*, i64*,
+                                     i64*, i64, i64);
+  void __kmpc_for_static_fini(id*, int);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+
+// loop being tested
+static int kind;
+static i64 lb, ub, incr;
+
+static i64 lower[N_TEAMS][N_THR];
+static i64 upper[N_TEAMS][N_THR];
+static int last[N_TEAMS][N_THR];
+static int nthreads[N_TEAMS];
+static int nteams;
+
+void inner(int *gtid, int *tid) {
+  int team = omp_get_team_num();
+  int t = omp_get_thread_num();
+  int l = 0;
+  nteams = omp_get_num_teams();
+  nthreads[team] = omp_get_num_threads();
+  if (kind == 4) {
+    int lo = (int)lb, hi = (int)ub, hid = 0, st = 1;
+    __kmpc_dist_for_static_init_4(&loc, *gtid, kmp_sch_static, &l, &lo, &hi,
+                                  &hid, &st, (int)incr, 1);
+    lower[team][t] = lo;
+    upper[team][t] = hi;
+  } else {
+    i64 lo = lb, hi = ub, hid = 0, st = 1;
+    __kmpc_dist_for_static_init_8(&loc, *gtid, kmp_sch_static, &l, &lo, &hi,
+                                  &hid, &st, incr, 1);
+    lower[team][t] = lo;
+    upper[team][t] = hi;
+  }
+  last[team][t] = l;
+  __kmpc_for_static_fini(&loc, *gtid);
+}
+
+void outer(int *gtid, int *tid) { __kmpc_fork_call(&loc, 0, (void *)inner); }
+
+// Returns the number of errors for lb..ub by incr, with per elements per
+// page when the team boundaries have to be aligned.
+static int run(int k, i64 l, i64 u, i64 inc, i64 per) {
+  i64 next = l, trip = (inc > 0 ? u - l : l - u) / (inc > 0 ? inc : -inc) + 1;
+  int nlast = 0, errors = 0;
+  int team, t;
+
+  kind = k;
+  lb = l;
+  ub = u;
+  incr = inc;
+  __kmpc_push_num_teams(&loc, __kmpc_global_thread_num(&loc), N_TEAMS, N_THR);
+  __kmpc_fork_teams(&loc, 0, (void *)outer);
+  for (team = 0; team < nteams; ++team) {
+    int first = 1;
+    for (t = 0; t < nthreads[team]; ++t) {
+      i64 lo = lower[team][t], hi = upper[team][t];
+      if (inc > 0 ? hi < lo : lo < hi) {
+        errors += last[team][t];
+        continue; // no iterations for this thread
+      }
+      if (lo != next)
+        errors++;
+      if (first && team > 0 && per > 0 && trip / nteams >= per &&
+          (inc > 0 ? lo : lo + 1) % per != 0)
+        errors++;
+      first = 0;
+      next = hi + inc;
+      if (last[team][t]) {
+        nlast++;
+        if (hi != u)
+          errors++;
+      }
+    }
+  }
+  if (next != u + inc || nlast != 1)
+    errors++;
+  if (errors)
+    printf("failed: kind %d lb %lld ub %lld incr %lld per %lld\n", k, l, u,
+           inc, per);
+  return errors;
+}
+
+int main() {
+  static const i64 trips[] = {1, 3, 4, 5, 11, 12, 100, 4099, 10000, 100003};
+  i64 per = sysconf(_SC_PAGESIZE) / 8;
+  int errors = 0;
+  int elem, i;
+
+  for (elem = 0; elem <= 8; elem += 8) {
+    kmpc_set_dist_element_size(elem);
+    for (i = 0; i < (int)(sizeof(trips) / sizeof(trips[0])); ++i) {
+      i64 trip = trips[i];
+      i64 p = elem ? per : 0;
+      errors += run(4, 0, trip - 1, 1, p);
+      errors += run(4, 7, 7 + trip - 1, 1, p);
+      errors += run(4, trip + 5, 6, -1, p);
+      errors += run(8, -1000, -1000 + trip - 1, 1, p);
+      errors += run(8, 3, 3 + 3 * (trip - 1), 3, 0);
+      errors += run(8, 3 * trip, 3, -3, 0);
+    }
+  }
+  if (errors)
+    printf("failed: %d errors\n", errors);
+  else
+    printf("passed\n");
+  return errors != 0;
+}
@@ -0,0 +1,170 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_NUM_THREADS=3 %libomp-run
+// RUN: env OMP_NUM_THREADS=7 %libomp-run
+// RUN: env KMP_SCHEDULE=static,balanced %libomp-run
+//
+// The test checks the partition __kmpc_for_static_init_* compute for
+// schedule(static) loops with unit increment, which divide the trip count by
+// the team size without a division instruction: the threads' blocks must be
+// contiguous, in thread order, cover the whole range, be at most one team
+// size apart, and only the thread with the last iteration may report it.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+enum sched {
+  kmp_sch_static = 34,
+};
+typedef long long i64;
+typedef unsigned long long u64;
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_for_static_init_4(id*, int, int, int*, int*, int*, int*, int,
+                                int);
+  void __kmpc_for_static_init_8(id*, int, int, int*, i64*, i64*, i64*, i64,
+                                i64);
+  void __kmpc_for_static_init_8u(id*, int, int, int*, u64*, u64*, i64*, i64,
+                                 i64);
+  void __kmpc_for_static_fini(id*, int);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+
+#define MAX_THREADS 64
+
+static u64 lower[MAX_THREADS];
+static u64 upper[MAX_THREADS];
+static int last[MAX_THREADS];
+
+// Checks the blocks of the loop lb..ub as unsigned numbers, relative to lb.
+static int check(int nthreads, u64 lb, u64 ub) {
+  u64 trip = ub - lb + 1;
+  u64 next = 0, size, max = 0;
+  int nlast = 0;
+  int t;
+
+  for (t = 0; t < nthreads; ++t) {
+    if (upper[t] < lower[t] || lower[t] < lb || upper[t] > ub) {
+      if (last[t])
+        return 1;
+      continue; // no iterations for this thread
+    }
+    if (lower[t] - lb != next)
+      return 1;
+    size = upper[t] - lower[t] + 1;
+    if (size > max)
+      max = size;
+    next += size;
+    if (last[t]) {
+      if (next != trip)
+        return 1;
+      nlast++;
+    }
+  }
+  if (next != trip || nlast != 1)
+    return 1;
+  // greedy blocks are trip/nthreads rounded up, balanced ones differ by one
+  if (trip >= (u64)nthreads && max > (trip + nthreads - 1) / nthreads)
+    return 1;
+  return 0;
+}
+
+static int run(int kind, i64 lb, i64 ub) {
+  int nthreads = 1;
+
+  #pragma omp parallel
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int tid = omp_get_thread_num();
+    int l = 0;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    if (kind == 4) {
+      int lo = (int)lb, hi = (int)ub, st = 1;
+      __kmpc_for_static_init_4(&loc, gtid, kmp_sch_static, &l, &lo, &hi, &st,
+                               1, 1);
+      lower[tid] = (u64)(i64)lo;
+      upper[tid] = (u64)(i64)hi;
+    } else if (kind == 8) {
+      i64 lo = lb, hi = ub, st = 1;
+      __kmpc_for_static_init_8(&loc, gtid, kmp_sch_static, &l, &lo, &hi, &st,
+                               1, 1);
+      lower[tid] = (u64)lo;
+      upper[tid] = (u64)hi;
+    } else {
+      u64 lo = (u64)lb, hi = (u64)ub;
+      i64 st = 1;
+      __kmpc_for_static_init_8u(&loc, gtid, kmp_sch_static, &l, &lo, &hi, &st,
+                                1, 1);
+      lower[tid] = lo;
+      upper[tid] = hi;
+    }
+    last[tid] = l;
+    __kmpc_for_static_fini(&loc, gtid);
+  }
+  // compare as unsigned numbers shifted so that lb maps to 0
+  if (kind != 0) {
+    u64 bias = (u64)1 << (kind == 4 ? 31 : 63);
+    int t;
+    for (t = 0; t < nthreads; ++t) {
+      if (kind == 4) {
+        lower[t] = (u64)(unsigned)((int)lower[t]) ^ bias;
+        upper[t] = (u64)(unsigned)((int)upper[t]) ^ bias;
+      } else {
+        lower[t] ^= bias;
+        upper[t] ^= bias;
+      }
+    }
+    if (kind == 4)
+      return check(nthreads, (u64)(unsigned)(int)lb ^ bias,
+                   (u64)(unsigned)(int)ub ^ bias);
+    return check(nthreads, (u64)lb ^ bias, (u64)ub ^ bias);
+  }
+  return check(nthreads, (u64)lb, (u64)ub);
+}
+
+int main() {
+  static const i64 trips[] = {1,    2,    3,     5,       7,         8,
+                              63,   64,   65,    1000,    1001,      99991,
+                              4096, 65537, 1000003, 0x7fffffff, 0xfffffffeLL};
+  int errors = 0;
+  int n, i;
+
+  for (n = 2; n <= 8; ++n) {
+    omp_set_num_threads(n);
+    for (i = 0; i < (int)(sizeof(trips) / sizeof(trips[0])); ++i) {
+      i64 trip = trips[i];
+      if (trip <= 0x7fffffff) {
+        errors += run(4, 0, trip - 1);
+        errors += run(4, -(trip / 2), trip - 1 - trip / 2);
+      }
+      errors += run(8, -3, trip - 4);
+      errors += run(8, 0x7fffffffffffffffLL - trip + 1, 0x7fffffffffffffffLL);
+      errors += run(0, (i64)((u64)-1 - trip + 1), (i64)(u64)-1);
+      errors += run(0, 5, 5 + trip - 1);
+    }
+    // trip counts beyond 32 bits
+    errors += run(8, 0, 0x100000005LL);
+    errors += run(0, 1, 0x7fffffffffffLL);
+  }
+  if (errors)
+    printf("failed: %d errors\n", errors);
+  else
+    printf("passed\n");
+  return errors != 0;
+}
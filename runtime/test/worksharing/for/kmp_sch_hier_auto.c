@@ -0,0 +1,99 @@
+// RUN: %libomp-compile
+// RUN: env KMP_DISP_HIER_AUTO=2 OMP_SCHEDULE=dynamic   %libomp-run
+// RUN: env KMP_DISP_HIER_AUTO=2 OMP_SCHEDULE=dynamic,3 %libomp-run
+// RUN: env KMP_DISP_HIER_AUTO=2 OMP_SCHEDULE=guided    %libomp-run
+// RUN: env KMP_DISP_HIER_AUTO=2 OMP_SCHEDULE=guided,2  %libomp-run
+// RUN: env KMP_DISP_HIER_AUTO=2 OMP_SCHEDULE=static    %libomp-run
+// RUN: env KMP_DISP_HIER_AUTO=2 KMP_ADAPTIVE_AUTO=1 %libomp-run
+//
+// The test checks the automatic scheduling hierarchy. Setting
+// KMP_DISP_HIER_AUTO forces it for schedule(runtime) and schedule(auto) loops
+// of teams of at least that many threads, even with one NUMA domain, while
+// loops with dynamic or guided written in the source keep their schedule.
+// Every iteration must be executed exactly once either way, also when the
+// dispatch buffers are reused by many consecutive loops.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+enum sched {
+  kmp_sch_dynamic_chunked = 35,
+  kmp_sch_guided_chunked = 36,
+  kmp_sch_runtime = 37,
+  kmp_sch_auto = 38,
+};
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_dispatch_init_4(id*, int, enum sched, int, int, int, int);
+  int __kmpc_dispatch_next_4(id*, int, void*, void*, void*, void*);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+static id loc = {0, 2, 0, 0, ";file;func;0;0;;"};
+
+#define N 1000
+#define LOOPS 20
+
+static int count[N];
+
+// Run the loop 0..N-1 with the given schedule; returns the number of errors.
+static int run_loop(enum sched schedule, int chunk) {
+  int errors = 0;
+  int i;
+
+  for (i = 0; i < N; ++i)
+    count[i] = 0;
+  #pragma omp parallel num_threads(4)
+  {
+    int gtid = __kmpc_global_thread_num(&loc);
+    int lb, ub, st, last;
+    int j;
+    __kmpc_dispatch_init_4(&loc, gtid, schedule, 0, N - 1, 1, chunk);
+    while (__kmpc_dispatch_next_4(&loc, gtid, &last, &lb, &ub, &st)) {
+      for (j = lb; j <= ub; j += st) {
+        #pragma omp atomic
+        count[j]++;
+      }
+    }
+  }
+  for (i = 0; i < N; ++i) {
+    if (count[i] != 1) {
+      fprintf(stderr, "schedule %d: iteration %d executed %d times\n",
+              (int)schedule, i, count[i]);
+      errors++;
+    }
+  }
+  return errors;
+}
+
+int main() {
+  int errors = 0;
+  int i;
+
+  for (i = 0; i < LOOPS; ++i) {
+    errors += run_loop(kmp_sch_runtime, 0);
+    errors += run_loop(kmp_sch_auto, 0);
+    errors += run_loop(kmp_sch_dynamic_chunked, 1 + i % 4);
+    errors += run_loop(kmp_sch_guided_chunked, 1 + i % 4);
+  }
+  if (errors) {
+    fprintf(stderr, "failed, %d errors\n", errors);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -0,0 +1,191 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_NUM_THREADS=3 %libomp-run
+//
+// The test checks kmpc_set_loop_weights(): the static loop at the registered
+// location with the registered trip count is split into contiguous blocks of
+// about equal cost, other trip counts and other loops keep the usual
+// partition, and every iteration is executed exactly once, also while the
+// profile is replaced concurrently.
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+
+// ---------------------------------------------------------------------------
+// Various definitions copied from OpenMP RTL.
+enum sched {
+  kmp_sch_static = 34,
+};
+typedef unsigned long long u64;
+typedef struct {
+  int reserved_1;
+  int flags;
+  int reserved_2;
+  int reserved_3;
+  char *psource;
+} id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int __kmpc_global_thread_num(id*);
+  void __kmpc_for_static_init_4(id*, int, int, int*, int*, int*, int*, int,
+                                int);
+  void __kmpc_for_static_fini(id*, int);
+#ifdef __cplusplus
+} // extern "C"
+#endif
+// End of definitions copied from OpenMP RTL.
+// ---------------------------------------------------------------------------
+static id loc = {0, 2, 0, 0, ";/src/app/solver.c;run_loop;62;5;;"};
+static id other = {0, 2, 0, 0, ";/src/app/solver.c;run_loop;63;5;;"};
+static id suffix = {0, 2, 0, 0, ";/src/app/mysolver.c;run_loop;62;5;;"};
+
+#define N 1000
+#define MAX_THREADS 64
+
+static u64 prefix[N], prefix2[N];
+static int count[N];
+static u64 cost[MAX_THREADS];
+static int blocks[MAX_THREADS];
+
+// Cost of iteration i: the second half is ten times as expensive.
+static u64 weight(int i) { return i < N / 2 ? 1 : 10; }
+
+// Run the loop 0..n-1 at location l; returns the number of errors.
+static int run_loop(id *l, int n, int weighted) {
+  int errors = 0;
+  int nthreads = 0;
+  int i;
+
+  for (i = 0; i < MAX_THREADS; ++i) {
+    cost[i] = 0;
+    blocks[i] = 0;
+  }
+  #pragma omp parallel
+  {
+    int gtid = __kmpc_global_thread_num(l);
+    int tid = omp_get_thread_num();
+    int lb = 0, ub = n - 1, st = 1, last = 0;
+    int j;
+    #pragma omp single
+    nthreads = omp_get_num_threads();
+    __kmpc_for_static_init_4(l, gtid, kmp_sch_static, &last, &lb, &ub, &st, 1,
+                             1);
+    for (j = lb; j <= ub; ++j) {
+      #pragma omp atomic
+      count[j]++;
+      cost[tid] += weight(j);
+      blocks[tid]++;
+    }
+    if (last && ub != n - 1) {
+      #pragma omp atomic
+      errors++;
+    }
+    __kmpc_for_static_fini(l, gtid);
+  }
+  for (i = 0; i < N; ++i) {
+    if (count[i] != (i < n))
+      errors++;
+    count[i] = 0;
+  }
+  if (nthreads > 1 && nthreads <= MAX_THREADS) {
+    u64 total = 0, max = 0;
+    for (i = 0; i < nthreads; ++i) {
+      total += cost[i];
+      if (cost[i] > max)
+        max = cost[i];
+    }
+    // equal-cost blocks differ by at most one iteration, plain blocks differ
+    // by at most one iteration in length
+    if (weighted && max > total / nthreads + 10) {
+      fprintf(stderr, "weighted partition unbalanced: max %llu of %llu\n",
+              max, total);
+      errors++;
+    }
+    if (!weighted && (blocks[0] < n / nthreads || blocks[0] > n / nthreads + 1)) {
+      fprintf(stderr, "unexpected partition: %d of %d\n", blocks[0], n);
+      errors++;
+    }
+  }
+  return errors;
+}
+
+// Inner teams of two threads run weighted loops while the primary thread of
+// the outer team keeps replacing the profile; returns the number of errors.
+static int run_concurrent(void) {
+  int errors = 0;
+  int done = 0;
+
+  omp_set_max_active_levels(2);
+  #pragma omp parallel num_threads(3) shared(done) reduction(+:errors)
+  {
+    if (omp_get_thread_num() == 0) {
+      int r;
+      for (r = 0; r < 2000; ++r)
+        kmpc_set_loop_weights("solver.c:62", r % 2 ? prefix : prefix2, N);
+      #pragma omp atomic write
+      done = 1;
+    } else {
+      int d;
+      do {
+        int local[N] = {0};
+        int i;
+        #pragma omp parallel num_threads(2) shared(local)
+        {
+          int gtid = __kmpc_global_thread_num(&loc);
+          int lb = 0, ub = N - 1, st = 1, last = 0;
+          int j;
+          __kmpc_for_static_init_4(&loc, gtid, kmp_sch_static, &last, &lb,
+                                   &ub, &st, 1, 1);
+          for (j = lb; j <= ub; ++j)
+            local[j]++;
+          __kmpc_for_static_fini(&loc, gtid);
+        }
+        for (i = 0; i < N; ++i)
+          if (local[i] != 1)
+            errors++;
+        #pragma omp atomic read
+        d = done;
+      } while (!d);
+    }
+  }
+  omp_set_max_active_levels(1);
+  return errors;
+}
+
+int main() {
+  int errors = 0;
+  int i;
+  u64 sum = 0;
+
+  for (i = 0; i < N; ++i) {
+    sum += weight(i);
+    prefix[i] = sum;
+    prefix2[i] = i + 1;
+  }
+  errors += run_loop(&loc, N, 0);
+  kmpc_set_loop_weights("solver.c:62", prefix, N);
+  errors += run_loop(&loc, N, 1);
+  errors += run_loop(&loc, N, 1); // cached partition
+  errors += run_loop(&loc, N - 1, 0); // other trip count
+  errors += run_loop(&other, N, 0); // other line
+  errors += run_loop(&suffix, N, 0); // other file
+  // a profile for the whole path is the same loop
+  kmpc_set_loop_weights("/src/app/solver.c:62", prefix, N);
+  errors += run_loop(&loc, N, 1);
+  kmpc_set_loop_weights("/src/app/solver.c:62", NULL, N);
+  // replacing the profile drops the cached partitions
+  kmpc_set_loop_weights("solver.c:62", prefix2, N);
+  errors += run_loop(&loc, N, 0);
+  kmpc_set_loop_weights("solver.c:62", prefix, N);
+  errors += run_loop(&loc, N, 1);
+  errors += run_concurrent();
+  // removing the profile restores the even partition
+  kmpc_set_loop_weights("solver.c:62", NULL, N);
+  errors += run_loop(&loc, N, 0);
+  if (errors)
+    printf("failed: %d errors\n", errors);
+  else
+    printf("passed\n");
+  return errors != 0;
+}
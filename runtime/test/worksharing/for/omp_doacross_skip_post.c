@@ -0,0 +1,59 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_DOACROSS_WINDOW=0 %libomp-run
+// XFAIL: gcc-4, gcc-5, clang-3.7, clang-3.8, icc-15, icc-16
+//
+// Iterations that never post their source must not hold up the rest of a
+// large loop: only the even iterations post and wait for the previous even
+// iteration, the odd ones take no part in the ordering at all.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N ((1 << 21) + 7) // more iterations than a flag window would take
+
+static int *a;
+
+int test_doacross_skip_post() {
+  int i;
+  int errors = 0;
+
+  for (i = 0; i < N; ++i)
+    a[i] = 0;
+  #pragma omp parallel
+  {
+    int k;
+    #pragma omp for ordered(1) schedule(static, 64)
+    for (k = 0; k < N; ++k) {
+      if (k % 2 == 0) {
+        #pragma omp ordered depend(sink : k - 2)
+        a[k] = k >= 2 ? a[k - 2] + 1 : 1;
+        #pragma omp ordered depend(source)
+      } else {
+        a[k] = -1;
+      }
+    }
+  }
+  for (i = 0; i < N; ++i) {
+    if (a[i] != (i % 2 == 0 ? i / 2 + 1 : -1)) {
+      fprintf(stderr, "a[%d] = %d\n", i, a[i]);
+      errors++;
+      break;
+    }
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv) {
+  int i;
+  int num_failed = 0;
+  if (omp_get_max_threads() < 2)
+    omp_set_num_threads(4);
+  a = (int *)malloc(sizeof(int) * N);
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_doacross_skip_post()) {
+      num_failed++;
+    }
+  }
+  free(a);
+  return num_failed;
+}
@@ -0,0 +1,81 @@
+// RUN: %libomp-compile
+// RUN: %libomp-run
+// RUN: env KMP_DOACROSS_WINDOW=64 %libomp-run
+// RUN: env KMP_DOACROSS_WINDOW=1000 %libomp-run
+// RUN: env KMP_DOACROSS_WINDOW=0 %libomp-run
+// XFAIL: gcc-4, gcc-5, clang-3.7, clang-3.8, icc-15, icc-16
+//
+// Wavefronts whose dependence distance is much larger than the window of
+// iteration flags set with KMP_DOACROSS_WINDOW, with non-unit and negative
+// increments, must still observe all their dependencies.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N 200
+
+static int m[N][N];
+
+int test_doacross_window() {
+  int i, j;
+  int errors = 0;
+
+  for (i = 0; i < N; ++i) {
+    for (j = 0; j < N; ++j)
+      m[i][j] = 0;
+    m[i][0] = i;
+    m[0][i] = i;
+  }
+  #pragma omp parallel
+  {
+    int row, col;
+    #pragma omp for ordered(2) schedule(static, 1)
+    for (row = 1; row < N; ++row) {
+      for (col = 1; col < N; ++col) {
+        #pragma omp ordered depend(sink : row - 1, col) depend(sink : row, col - 1)
+        m[row][col] = m[row - 1][col] + m[row][col - 1] - m[row - 1][col - 1];
+        #pragma omp ordered depend(source)
+      }
+    }
+  }
+  if (m[N - 1][N - 1] != 2 * (N - 1))
+    errors++;
+
+  // Reverse wavefront over even rows and columns, starting at the last
+  // row and column
+  for (i = 0; i < N; ++i)
+    for (j = 0; j < N; ++j)
+      m[i][j] = 0;
+  #pragma omp parallel
+  {
+    int row, col;
+    #pragma omp for ordered(2) schedule(dynamic)
+    for (row = N - 2; row >= 0; row -= 2) {
+      for (col = N - 2; col >= 0; col -= 2) {
+        #pragma omp ordered depend(sink : row + 2, col) depend(sink : row, col + 2)
+        m[row][col] = 1 + (row + 2 < N ? m[row + 2][col] : 0) +
+                      (col + 2 < N ? m[row][col + 2] : 0) -
+                      (row + 2 < N && col + 2 < N ? m[row + 2][col + 2] : 0);
+        #pragma omp ordered depend(source)
+      }
+    }
+  }
+  if (m[0][0] != (N / 2) * (N / 2))
+    errors++;
+  if (errors)
+    fprintf(stderr, "wavefront results are wrong\n");
+  return errors == 0;
+}
+
+int main(int argc, char **argv) {
+  int i;
+  int num_failed = 0;
+  if (omp_get_max_threads() < 2)
+    omp_set_num_threads(4);
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_doacross_window()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
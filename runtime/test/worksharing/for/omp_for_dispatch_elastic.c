@@ -0,0 +1,77 @@
+// RUN: %libomp-compile
+// RUN: env KMP_DISP_ELASTIC=1 %libomp-run
+// RUN: env KMP_DISP_ELASTIC=1 KMP_DISP_NUM_BUFFERS=2 %libomp-run
+// RUN: env KMP_DISP_ELASTIC=1 KMP_DISP_NUM_BUFFERS=2 OMP_NUM_THREADS=3 \
+// RUN:   %libomp-run
+// RUN: %libomp-run
+//
+// Many dynamic nowait loops in a row while one thread is delayed, so that the
+// other threads run far more loops ahead than there are dispatch buffers.
+// Every iteration of every loop must still be executed exactly once and
+// ordered regions must still run in iteration order.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define LOOPS 64
+#define N 101
+
+static int count[LOOPS][N];
+static int next[LOOPS];
+
+int test_omp_for_dispatch_elastic() {
+  int errors = 0;
+  int i, j;
+
+  #pragma omp parallel private(j)
+  {
+    if (omp_get_thread_num() == omp_get_num_threads() - 1)
+      my_sleep(0.05);
+    for (j = 0; j < LOOPS; ++j) {
+      if (j % 4 == 3) {
+        #pragma omp for schedule(dynamic, 2) ordered nowait
+        for (i = 0; i < N; ++i) {
+          #pragma omp ordered
+          {
+            if (next[j] == i)
+              next[j] = i + 1;
+          }
+          #pragma omp atomic
+          count[j][i]++;
+        }
+      } else {
+        #pragma omp for schedule(monotonic:dynamic, 3) nowait
+        for (i = 0; i < N; ++i) {
+          #pragma omp atomic
+          count[j][i]++;
+        }
+      }
+    }
+  }
+  for (j = 0; j < LOOPS; ++j) {
+    for (i = 0; i < N; ++i) {
+      if (count[j][i] != 1)
+        errors++;
+      count[j][i] = 0;
+    }
+    if (j % 4 == 3 && next[j] != N)
+      errors++;
+    next[j] = 0;
+  }
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_dispatch_elastic()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,77 @@
+// RUN: %libomp-compile-and-run
+// RUN: env OMP_NUM_THREADS=7 %libomp-run
+//
+// Threads waiting for their turn in an ordered loop are handed the turn by
+// the thread that finishes the previous iteration, and may run tasks while
+// they wait. Ordered regions must run in iteration order, also when only some
+// iterations execute the ordered region, and the tasks must all complete.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N 3001
+#define TASKS 200
+
+int test_omp_for_ordered_handoff() {
+  int errors = 0;
+  int tasks_done = 0;
+  int next = 0;
+  long long lnext = N;
+  int i;
+  long long l;
+
+  #pragma omp parallel
+  {
+    int t;
+    #pragma omp single nowait
+    for (t = 0; t < TASKS; ++t) {
+      #pragma omp task
+      {
+        #pragma omp atomic
+        tasks_done++;
+      }
+    }
+
+    #pragma omp for schedule(dynamic) ordered nowait
+    for (i = 0; i < N; ++i) {
+      #pragma omp ordered
+      {
+        if (next != i)
+          errors++;
+        next = i + 1;
+      }
+    }
+
+    // only every third iteration runs the ordered region
+    #pragma omp for schedule(dynamic, 2) ordered
+    for (l = N; l > 0; --l) {
+      if (l % 3 == 0) {
+        #pragma omp ordered
+        {
+          if (lnext <= l)
+            errors++;
+          lnext = l;
+        }
+      }
+    }
+  }
+  if (next != N || lnext != 3)
+    errors++;
+  if (tasks_done != TASKS)
+    errors++;
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_ordered_handoff()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
@@ -0,0 +1,62 @@
+// RUN: %libomp-compile
+// RUN: env KMP_FORCE_REDUCTION=tree %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=tree KMP_FUSED_REDUCTION_BARRIER=1 %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=tree KMP_FUSED_REDUCTION_BARRIER=1 \
+// RUN:   KMP_REDUCTION_BARRIER_PATTERN=linear,linear %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=atomic KMP_FUSED_REDUCTION_BARRIER=1 %libomp-run
+// RUN: env KMP_FORCE_REDUCTION=critical KMP_FUSED_REDUCTION_BARRIER=1 \
+// RUN:   %libomp-run
+//
+// Microbenchmark for reductions on worksharing loops without nowait.  The
+// first run uses the regular reduction barrier followed by the loop's own
+// barrier; the others fuse both into a single barrier.  The time per loop is
+// printed so the runs can be compared.
+#include <stdio.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define N 64
+#define REPS 1000
+
+int test_omp_for_reduction_fused_barrier() {
+  int errors = 0;
+  double start, time;
+  long sum = 0;
+  int last = -1;
+  start = omp_get_wtime();
+  #pragma omp parallel shared(sum, last) reduction(+:errors)
+  {
+    int reps;
+    for (reps = 0; reps < REPS; ++reps) {
+      int i;
+      #pragma omp for reduction(+:sum) lastprivate(last)
+      for (i = 0; i < N; ++i) {
+        sum += i + 1;
+        last = i;
+      }
+      // The fused barrier must still publish both the reduced value and the
+      // lastprivate copy to every thread.
+      if (sum != (long)(reps + 1) * N * (N + 1) / 2 || last != N - 1)
+        errors++;
+      #pragma omp barrier
+      #pragma omp single
+      last = -1;
+    }
+  }
+  time = omp_get_wtime() - start;
+  fprintf(stderr, "%d threads: %.3f us per loop\n", omp_get_max_threads(),
+          time / REPS * 1e6);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_reduction_fused_barrier()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
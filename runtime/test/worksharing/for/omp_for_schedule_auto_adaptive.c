@@ -0,0 +1,85 @@
+// RUN: %libomp-compile
+// RUN: %libomp-run
+// RUN: env KMP_ADAPTIVE_AUTO=1 %libomp-run
+// RUN: env KMP_ADAPTIVE_AUTO=1 OMP_SCHEDULE=auto %libomp-run
+//
+// schedule(auto) loops are tuned per call site from the timings of their
+// previous executions. The cost of the iterations is triangular so that the
+// adaptive schedule moves away from the even partition; every execution must
+// still run every iteration exactly once, also with a different trip count
+// for the same call site.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N 1500
+#define EXECUTIONS 40
+
+static int count[N];
+
+static double work(int i) {
+  int j;
+  double s = 0;
+  for (j = 0; j < i; ++j)
+    s += (double)j / (i + 1);
+  return s;
+}
+
+static int check(int n) {
+  int i, errors = 0;
+  for (i = 0; i < N; ++i) {
+    if (count[i] != (i < n))
+      errors++;
+    count[i] = 0;
+  }
+  return errors;
+}
+
+int test_omp_for_schedule_auto_adaptive() {
+  int errors = 0;
+  int e;
+
+  for (e = 0; e < EXECUTIONS; ++e) {
+    // every eighth execution has a different trip count
+    int n = e % 8 == 7 ? N / 3 : N;
+    double sum = 0;
+    long l;
+    #pragma omp parallel reduction(+:sum)
+    {
+      int i;
+      #pragma omp for schedule(auto)
+      for (i = 0; i < n; ++i) {
+        sum += work(i);
+        #pragma omp atomic
+        count[i]++;
+      }
+      #pragma omp single
+      errors += check(n);
+
+      #pragma omp for schedule(runtime)
+      for (l = n - 1; l >= 0; --l) {
+        sum += work((int)l);
+        #pragma omp atomic
+        count[l]++;
+      }
+    }
+    errors += check(n);
+    if (sum < 0)
+      errors++;
+  }
+  if (errors)
+    fprintf(stderr, "%d iterations not executed exactly once\n", errors);
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_schedule_auto_adaptive()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
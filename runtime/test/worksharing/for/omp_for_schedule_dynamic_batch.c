@@ -0,0 +1,86 @@
+// RUN: %libomp-compile
+// RUN: env KMP_DISP_CHUNK_BATCH=8 %libomp-run
+// RUN: env KMP_DISP_CHUNK_BATCH=64 OMP_NUM_THREADS=3 %libomp-run
+//
+// With KMP_DISP_CHUNK_BATCH each thread grabs several chunks of a dynamic loop
+// at once. Every iteration must still be executed exactly once, each thread
+// must see its chunks in increasing order, and ordered loops must still run
+// their ordered regions in iteration order.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N 10007
+
+static int count[N];
+
+static int check(const char *name) {
+  int i, errors = 0;
+  for (i = 0; i < N; ++i) {
+    if (count[i] != 1)
+      errors++;
+    count[i] = 0;
+  }
+  if (errors)
+    fprintf(stderr, "%s: %d iterations not executed exactly once\n", name,
+            errors);
+  return errors;
+}
+
+int test_omp_for_schedule_dynamic_batch() {
+  int errors = 0;
+  int next = 0;
+  int i;
+  long long l;
+
+  #pragma omp parallel reduction(+:errors)
+  {
+    int prev = -1;
+    long long lprev = N;
+
+    #pragma omp for schedule(monotonic:dynamic, 3)
+    for (i = 0; i < N; ++i) {
+      if (i <= prev)
+        errors++; // not monotonic
+      prev = i;
+      #pragma omp atomic
+      count[i]++;
+    }
+    #pragma omp single
+    errors += check("int");
+
+    #pragma omp for schedule(monotonic:dynamic)
+    for (l = N - 1; l >= 0; --l) {
+      if (l >= lprev)
+        errors++; // not monotonic
+      lprev = l;
+      #pragma omp atomic
+      count[l]++;
+    }
+    #pragma omp single
+    errors += check("long long");
+
+    #pragma omp for schedule(dynamic, 2) ordered
+    for (i = 0; i < N; ++i) {
+      #pragma omp ordered
+      {
+        if (next != i)
+          errors++;
+        next = i + 1;
+      }
+    }
+  }
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_schedule_dynamic_batch()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}
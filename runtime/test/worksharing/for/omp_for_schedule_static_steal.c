@@ -0,0 +1,94 @@
+// RUN: %libomp-compile
+// RUN: env OMP_SCHEDULE=static_steal %libomp-run
+// RUN: env OMP_SCHEDULE=static_steal,3 %libomp-run
+// RUN: env OMP_SCHEDULE=static_steal KMP_STEAL_PAIR=dcas %libomp-run
+// RUN: env OMP_SCHEDULE=static_steal,3 KMP_STEAL_PAIR=lock %libomp-run
+//
+// static_steal loops with 4- and 8-byte induction variables. The work is
+// unbalanced so that threads run out of their own chunks and steal; every
+// iteration must still be executed exactly once. The 8-byte loops pack their
+// chunk counters into 8 bytes unless KMP_STEAL_PAIR turns that off: with dcas
+// they use 16-byte CAS where the CPU has cmpxchg16b, with lock the lock.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+#include "omp_my_sleep.h"
+
+#define N 20000
+
+static int count[N];
+
+static void delay(long long i) {
+  // the first quarter of the iterations is much more expensive
+  if (i < N / 4)
+    my_sleep(0.00001);
+}
+
+static int check(const char *name) {
+  int i, errors = 0;
+  for (i = 0; i < N; ++i) {
+    if (count[i] != 1)
+      errors++;
+    count[i] = 0;
+  }
+  if (errors)
+    fprintf(stderr, "%s: %d iterations not executed exactly once\n", name,
+            errors);
+  return errors;
+}
+
+int test_omp_for_schedule_static_steal() {
+  int errors = 0;
+  int i;
+  long long l;
+  unsigned long long u;
+
+  #pragma omp parallel
+  {
+    #pragma omp for schedule(runtime)
+    for (i = 0; i < N; ++i) {
+      delay(i);
+      #pragma omp atomic
+      count[i]++;
+    }
+    #pragma omp single
+    errors += check("int");
+
+    #pragma omp for schedule(runtime)
+    for (l = 0; l < N; ++l) {
+      delay(l);
+      #pragma omp atomic
+      count[l]++;
+    }
+    #pragma omp single
+    errors += check("long long");
+
+    #pragma omp for schedule(runtime)
+    for (u = 3 * (unsigned long long)N - 1; u > 2 * N - 1; u -= 2) {
+      delay((u - 2 * N) / 2);
+      #pragma omp atomic
+      count[(u - 2 * N) / 2 + N / 2]++;
+    }
+    #pragma omp for schedule(runtime) nowait
+    for (l = (long long)N / 2 - 1; l >= 0; --l) {
+      #pragma omp atomic
+      count[l]++;
+    }
+    #pragma omp barrier
+    #pragma omp single
+    errors += check("unsigned long long");
+  }
+  return errors == 0;
+}
+
+int main() {
+  int i;
+  int num_failed = 0;
+
+  for (i = 0; i < REPETITIONS; i++) {
+    if (!test_omp_for_schedule_static_steal()) {
+      num_failed++;
+    }
+  }
+  return num_failed;
+}